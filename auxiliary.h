@@ -13,17 +13,37 @@ static_assert(sizeof(byte) == 1u, "Size of \"byte\" typedef not equal to 8 bit."
 #define forceinline			inline __attribute__((always_inline))
 #define selectany			__attribute__((weak))
 
+// For more than a handful of literals prefer aux::EnumMap, which parses with a single hash lookup
 #define EnumCompare(inputString, comparedLiteral) \
 	(inputString.size() == sizeof(comparedLiteral) - 1u && memcmp(inputString.data(), comparedLiteral, sizeof(comparedLiteral) - 1u) == 0)
 
 //-------------------------------------------------------------------------------------------------
 /// auxiliary
 //-------------------------------------------------------------------------------------------------
+#include "source/CpuDispatch.h"
 #include "source/Miscellaneous.h"
+#include "source/SamplesInterleaving.h"
+#include "source/SamplesQuantization.h"
+#include "source/SamplesStatistics.h"
 #include "source/Hash.h"
+#include "source/EnumMap.h"
+#include "source/BloomFilter.h"
+#include "source/CountMinSketch.h"
+#include "source/TreeHash.h"
+#include "source/ShardRouting.h"
+#include "source/Allocators.h"
+#include "source/Arena.h"
 #include "source/FixedArray.h"
+#include "source/SmallFixedArray.h"
+#include "source/SoaArray.h"
+#include "source/MappedArray.h"
 #include "source/FixedStream.h"
 #include "source/VectorStream.h"
+#include "source/SampleConvertingStream.h"
+#include "source/PolyphaseResampler.h"
 #include "source/ChunkedStorage.h"
+#include "source/ThreadPool.h"
+#include "source/ParallelAlgorithms.h"
+#include "source/RadixSort.h"
 #include "source/Clock.h"
 #include "source/FileSystemUtils.h"
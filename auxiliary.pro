@@ -38,7 +38,7 @@ QMAKE_CXXFLAGS_WARN_ON += \
 #-------------------------------------------------------------------------------------------------
 QMAKE_CXXFLAGS += \
 	-m64 \
-	-msse -msse2 -msse3 -mssse3 -msse4 -msse4.1 -msse4.2 -mavx -mf16c \
+	-msse -msse2 -msse3 -mssse3 -msse4 -msse4.1 -msse4.2 \
 	-g \
 	-fpic \
 	-fdata-sections \
@@ -66,20 +66,51 @@ CONFIG(debug, debug|release) {
 # files
 #-------------------------------------------------------------------------------------------------
 SOURCES += \
+	source/Arena.cpp \
+	source/CountMinSketch.cpp \
+	source/CpuDispatch.cpp \
 	source/FixedStream.cpp \
+	source/MappedArray.cpp \
+	source/PolyphaseResampler.cpp \
+	source/PolyphaseResamplerAvx.cpp \
+	source/SamplesKernels.cpp \
+	source/SamplesKernelsAvx.cpp \
+	source/SamplesKernelsAvx2.cpp \
+	source/ThreadPool.cpp \
 	source/VectorStream.cpp
 
 HEADERS += \
 	platform/linux/platform.h \
 	auxiliary.h \
 	source/Hash.h \
+	source/EnumMap.h \
+	source/BloomFilter.h \
+	source/CountMinSketch.h \
+	source/TreeHash.h \
+	source/ShardRouting.h \
+	source/HashQuality.h \
+	source/ThreadPool.h \
+	source/ParallelAlgorithms.h \
+	source/RadixSort.h \
 	source/ChunkedStorage.h \
 	source/CompressedStorage.h \
+	source/Allocators.h \
+	source/Arena.h \
 	source/FixedArray.h \
+	source/SmallFixedArray.h \
+	source/SoaArray.h \
+	source/MappedArray.h \
 	source/FixedStream.h \
 	source/IStream.h \
+	source/SampleConvertingStream.h \
+	source/PolyphaseResampler.h \
 	source/JsonPrinter.h \
 	source/Miscellaneous.h \
+	source/CpuDispatch.h \
+	source/SamplesKernels.h \
+	source/SamplesInterleaving.h \
+	source/SamplesQuantization.h \
+	source/SamplesStatistics.h \
 	source/VectorStream.h \
 	source/Clock.h \
 	source/FileSystemUtils.h
@@ -0,0 +1,73 @@
+
+CONFIG(debug, debug|release) {
+	message("HashQuality_debug")
+
+	TARGET = HashQuality_debug
+	AUXILIARY_LIBRARY = auxiliary_debug
+
+	DESTDIR = $$_PRO_FILE_PWD_/../../../.dist
+	OBJECTS_DIR = $$_PRO_FILE_PWD_/../../../.int/HashQuality_debug
+
+} else {
+	message("HashQuality_release")
+
+	TARGET = HashQuality
+	AUXILIARY_LIBRARY = auxiliary
+
+	DESTDIR = $$_PRO_FILE_PWD_/../../../.dist
+	OBJECTS_DIR = $$_PRO_FILE_PWD_/../../../.int/HashQuality_release
+}
+
+TEMPLATE = app
+CONFIG += console c++14
+CONFIG -= qt app_bundle
+MAKEFILE = $$_PRO_FILE_PWD_/HashQuality.makefile
+
+#-------------------------------------------------------------------------------------------------
+# warnings
+#-------------------------------------------------------------------------------------------------
+QMAKE_CXXFLAGS_WARN_ON += \
+	-Wno-parentheses \
+	-Wno-unused-variable \
+	-Wno-unused-parameter \
+	-Wno-unused-local-typedefs \
+	-Wno-unused-but-set-variable \
+	-Wno-sign-compare \
+	-Wno-unused-function
+
+#-------------------------------------------------------------------------------------------------
+# compiler flags
+#-------------------------------------------------------------------------------------------------
+QMAKE_CXXFLAGS += \
+	-m64 \
+	-msse -msse2 -msse3 -mssse3 -msse4 -msse4.1 -msse4.2 \
+	-g \
+	-fno-strict-aliasing \
+	-I$$_PRO_FILE_PWD_/../.. \
+	-I$$_PRO_FILE_PWD_/../../platform/linux
+
+CONFIG(debug, debug|release) {
+	DEFINES += _DEBUG DEBUG
+
+} else {
+	DEFINES += NDEBUG
+
+	QMAKE_CXXFLAGS_RELEASE -= -O0 -O1 -O2
+	QMAKE_CXXFLAGS_RELEASE *= -O3
+}
+
+#-------------------------------------------------------------------------------------------------
+# libraries, auxiliary.pro must be built first
+#-------------------------------------------------------------------------------------------------
+LIBS += \
+	-L$$_PRO_FILE_PWD_/../../../.dist \
+	-l$$AUXILIARY_LIBRARY \
+	-lpthread
+
+PRE_TARGETDEPS += $$_PRO_FILE_PWD_/../../../.dist/lib$${AUXILIARY_LIBRARY}.a
+
+#-------------------------------------------------------------------------------------------------
+# files
+#-------------------------------------------------------------------------------------------------
+SOURCES += \
+	main.cpp
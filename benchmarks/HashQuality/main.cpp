@@ -0,0 +1,51 @@
+#include "platform.h"
+#include "auxiliary.h"
+#include "source/HashQuality.h"
+
+using namespace aux;
+
+
+//-------------------------------------------------------------------------------------------------
+/// Quality limits for 16 byte keys at the default samples counts, well above the sampling noise of
+/// a good hash and far below the bias of a broken one.
+//-------------------------------------------------------------------------------------------------
+static constexpr double			MaxAvalancheBias = 0.1;
+static constexpr double			MaxBitIndependenceBias = 0.25;
+static constexpr double			MaxSeedSensitivityBias = 0.1;
+
+//-------------------------------------------------------------------------------------------------
+template <typename Hasher>
+static bool CheckQuality(const char* hasherName, bool seeded)
+{
+	const HashBenchmark::QualityResult result = HashBenchmark::MeasureQuality(Hasher());
+	const bool passed = result.m_avalancheBias <= MaxAvalancheBias && result.m_bitIndependenceBias <= MaxBitIndependenceBias &&
+		(!seeded || result.m_seedSensitivityBias <= MaxSeedSensitivityBias);
+
+	std::cout << hasherName << (passed ? " passed" : " FAILED") << std::endl;
+
+	return passed;
+}
+
+//-------------------------------------------------------------------------------------------------
+/// Without arguments prints the throughput and quality report of every hasher, with --check only
+/// verifies the quality limits; the exit code is non-zero if any hasher fails them.
+//-------------------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	const bool checkOnly = argc > 1 && strcmp(argv[1], "--check") == 0;
+
+	if (!checkOnly)
+	{
+		HashBenchmark::Report<Murmur32Hasher>(std::cout, "Murmur32");
+		HashBenchmark::Report<Murmur64Hasher>(std::cout, "Murmur64");
+		HashBenchmark::Report<Murmur128HighHasher>(std::cout, "Murmur128High");
+		HashBenchmark::Report<TreeHash64Hasher>(std::cout, "TreeHash64");
+	}
+
+	bool passed = CheckQuality<Murmur32Hasher>("Murmur32", true);
+	passed = CheckQuality<Murmur64Hasher>("Murmur64", true) && passed;
+	passed = CheckQuality<Murmur128HighHasher>("Murmur128High", true) && passed;
+	passed = CheckQuality<TreeHash64Hasher>("TreeHash64", false) && passed;
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+#include "platform.h"
+#include "auxiliary.h"
+
+using namespace aux;
+
+
+//-------------------------------------------------------------------------------------------------
+/// Widens every int16_t sample into wide_t and narrows it back, once through the vector kernels and
+/// once in runs shorter than a vector, which only the scalar loops convert.
+//-------------------------------------------------------------------------------------------------
+template <typename wide_t>
+static bool CheckRoundTrip(const char* wideName)
+{
+	static constexpr uint64_t	SamplesCount = 65536u;
+	static constexpr uint64_t	ScalarRunLength = 7u;
+
+	std::vector<int16_t> input(SamplesCount);
+	std::vector<wide_t> widened(SamplesCount);
+	std::vector<int16_t> narrowed(SamplesCount);
+
+	for (uint64_t sampleIndex = 0u; sampleIndex != SamplesCount; ++sampleIndex)
+	{
+		input[sampleIndex] = static_cast<int16_t>(sampleIndex - 32768u);
+	}
+
+	samples_converter<int16_t, wide_t>::convert(input.data(), widened.data(), SamplesCount);
+	samples_converter<wide_t, int16_t>::convert(widened.data(), narrowed.data(), SamplesCount);
+
+	bool passed = narrowed == input;
+
+	for (uint64_t runStart = 0u; runStart < SamplesCount; runStart += ScalarRunLength)
+	{
+		const uint64_t runLength = std::min(ScalarRunLength, SamplesCount - runStart);
+
+		samples_converter<int16_t, wide_t>::convert(input.data() + runStart, widened.data() + runStart, runLength);
+		samples_converter<wide_t, int16_t>::convert(widened.data() + runStart, narrowed.data() + runStart, runLength);
+	}
+
+	passed = narrowed == input && passed;
+
+	std::cout << "int16_t -> " << wideName << " -> int16_t" << (passed ? " passed" : " FAILED") << std::endl;
+
+	return passed;
+}
+
+//-------------------------------------------------------------------------------------------------
+/// Checks that narrowing inverts widening at the ISA level CpuDispatch selects, AUX_ISA_LEVEL forces
+/// a lower one. The exit code is non-zero if any round trip changes a sample.
+//-------------------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	bool passed = CheckRoundTrip<int24_t>("int24_t");
+	passed = CheckRoundTrip<int32_t>("int32_t") && passed;
+
+	return passed ? 0 : 1;
+}
@@ -37,7 +37,8 @@
 #include <utime.h>
 #include <wchar.h>
 #include <wctype.h>
-#include <smmintrin.h>
+#include <immintrin.h>
+#include <cpuid.h>
 #include <libgen.h>
 
 //-------------------------------------------------------------------------------------------------
@@ -60,6 +61,13 @@
 #include <typeindex>
 #include <algorithm>
 #include <chrono>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+#include <exception>
 
 //-------------------------------------------------------------------------------------------------
 /// third party
@@ -0,0 +1,329 @@
+#pragma once
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// HeapAllocator
+	///
+	/// Blocks of at least MappingThreshold bytes are mmapped and Reallocate() grows or shrinks them
+	/// with mremap, which moves page table entries instead of copying data, whatever the alignment.
+	/// Smaller blocks come from the heap, Reallocate() between them goes through realloc when malloc
+	/// guarantees the alignment and copies otherwise, as it does when crossing the threshold; either
+	/// copy is shorter than MappingThreshold. Deallocate() tells the kinds apart by the byte count, so
+	/// it must be the one the block was allocated or last reallocated with.
+	//-------------------------------------------------------------------------------------------------
+	class HeapAllocator
+	{
+	public:
+		static constexpr size_t		MappingThreshold = 1u << 20;
+		static constexpr size_t		PageLength = 4096u;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline void* Allocate(size_t bytesCount, size_t alignment)
+		{
+			if (bytesCount >= MappingThreshold)
+			{
+				return Map(bytesCount, alignment);
+			}
+
+			void* memory = nullptr;
+
+			if (posix_memalign(&memory, std::max(alignment, sizeof(void*)), bytesCount) != 0)
+			{
+				throw std::bad_alloc();
+			}
+
+			return memory;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void* Reallocate(void* memory, size_t oldBytesCount, size_t newBytesCount, size_t alignment)
+		{
+			if (oldBytesCount >= MappingThreshold && newBytesCount >= MappingThreshold)
+			{
+				void* remappedMemory = mremap(memory, MappingLength(oldBytesCount), MappingLength(newBytesCount), MREMAP_MAYMOVE);
+
+				if (remappedMemory == MAP_FAILED)
+				{
+					throw std::bad_alloc();
+				}
+
+				if ((reinterpret_cast<uintptr_t>(remappedMemory) & (alignment - 1u)) == 0u)
+				{
+					return remappedMemory;
+				}
+
+				// Only alignments above the page length may get lost by moving the mapping
+				void* newMemory = Map(newBytesCount, alignment);
+
+				memcpy(newMemory, remappedMemory, std::min(oldBytesCount, newBytesCount));
+				munmap(remappedMemory, MappingLength(newBytesCount));
+
+				return newMemory;
+			}
+
+			if (oldBytesCount < MappingThreshold && newBytesCount < MappingThreshold && alignment <= alignof(std::max_align_t))
+			{
+				void* newMemory = realloc(memory, newBytesCount);
+
+				if (newMemory == nullptr)
+				{
+					throw std::bad_alloc();
+				}
+
+				return newMemory;
+			}
+
+			void* newMemory = Allocate(newBytesCount, alignment);
+
+			memcpy(newMemory, memory, std::min(oldBytesCount, newBytesCount));
+			Deallocate(memory, oldBytesCount);
+
+			return newMemory;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void Deallocate(void* memory, size_t bytesCount)
+		{
+			if (bytesCount >= MappingThreshold)
+			{
+				munmap(memory, MappingLength(bytesCount));
+				return;
+			}
+
+			free(memory);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool operator== (const HeapAllocator&) const
+		{
+			return true;
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		inline static size_t MappingLength(size_t bytesCount)
+		{
+			return (bytesCount + PageLength - 1u) & ~(PageLength - 1u);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Mappings are page aligned, stronger alignments over-map and trim the excess.
+		inline static void* Map(size_t bytesCount, size_t alignment)
+		{
+			const size_t mappingLength = MappingLength(bytesCount);
+			const size_t excessLength = alignment > PageLength ? alignment : 0u;
+			byte* memory = reinterpret_cast<byte*>(mmap(nullptr, mappingLength + excessLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+			if (memory == MAP_FAILED)
+			{
+				throw std::bad_alloc();
+			}
+
+			if (excessLength != 0u)
+			{
+				byte* alignedMemory = reinterpret_cast<byte*>((reinterpret_cast<uintptr_t>(memory) + alignment - 1u) & ~(alignment - 1u));
+				const size_t headLength = alignedMemory - memory;
+
+				if (headLength != 0u)
+				{
+					munmap(memory, headLength);
+				}
+
+				munmap(alignedMemory + mappingLength, excessLength - headLength);
+
+				memory = alignedMemory;
+			}
+
+			return memory;
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// HugePageAllocator
+	///
+	/// Allocations of at least one huge page are mmapped from the reserved huge pages pool (MAP_HUGETLB),
+	/// when the pool is empty they fall back to regular pages advised for transparent huge pages.
+	/// Smaller allocations come from the heap, so the allocator is safe to use for arrays of any size.
+	/// Mapped allocations are grown with mremap, which moves page table entries instead of copying data.
+	//-------------------------------------------------------------------------------------------------
+	class HugePageAllocator
+	{
+	public:
+		static constexpr size_t		HugePageLength = 2u << 20;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline void* Allocate(size_t bytesCount, size_t alignment)
+		{
+			if (bytesCount < HugePageLength)
+			{
+				return HeapAllocator().Allocate(bytesCount, alignment);
+			}
+
+			assert(alignment <= HugePageLength);
+
+			const size_t mappingLength = MappingLength(bytesCount);
+			void* memory = mmap(nullptr, mappingLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+			if (memory == MAP_FAILED)
+			{
+				// Over-map to be able to trim the mapping to a huge page boundary
+				byte* regularMemory = reinterpret_cast<byte*>(mmap(nullptr, mappingLength + HugePageLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+				if (regularMemory == MAP_FAILED)
+				{
+					throw std::bad_alloc();
+				}
+
+				byte* alignedMemory = reinterpret_cast<byte*>((reinterpret_cast<uintptr_t>(regularMemory) + HugePageLength - 1u) & ~(HugePageLength - 1u));
+				const size_t headLength = alignedMemory - regularMemory;
+
+				if (headLength != 0u)
+				{
+					munmap(regularMemory, headLength);
+				}
+
+				munmap(alignedMemory + mappingLength, HugePageLength - headLength);
+
+				madvise(alignedMemory, mappingLength, MADV_HUGEPAGE);
+
+				memory = alignedMemory;
+			}
+
+			return memory;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void* Reallocate(void* memory, size_t oldBytesCount, size_t newBytesCount, size_t alignment)
+		{
+			if (oldBytesCount < HugePageLength && newBytesCount < HugePageLength)
+			{
+				return HeapAllocator().Reallocate(memory, oldBytesCount, newBytesCount, alignment);
+			}
+
+			const size_t preservedLength = std::min(oldBytesCount, newBytesCount);
+
+			if (oldBytesCount >= HugePageLength && newBytesCount >= HugePageLength)
+			{
+				void* remappedMemory = mremap(memory, MappingLength(oldBytesCount), MappingLength(newBytesCount), MREMAP_MAYMOVE);
+
+				if (remappedMemory != MAP_FAILED)
+				{
+					if ((reinterpret_cast<uintptr_t>(remappedMemory) & (alignment - 1u)) == 0u)
+					{
+						return remappedMemory;
+					}
+
+					memory = remappedMemory;
+					oldBytesCount = newBytesCount;
+				}
+			}
+
+			// Crossing the huge page threshold, or the mapping could not be remapped in place of the old one
+			void* newMemory = Allocate(newBytesCount, alignment);
+
+			memcpy(newMemory, memory, preservedLength);
+			Deallocate(memory, oldBytesCount);
+
+			return newMemory;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void Deallocate(void* memory, size_t bytesCount)
+		{
+			if (bytesCount < HugePageLength)
+			{
+				HeapAllocator().Deallocate(memory, bytesCount);
+				return;
+			}
+
+			munmap(memory, MappingLength(bytesCount));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool operator== (const HugePageAllocator&) const
+		{
+			return true;
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		inline static size_t MappingLength(size_t bytesCount)
+		{
+			return (bytesCount + HugePageLength - 1u) & ~(HugePageLength - 1u);
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// StlAllocator - standard library allocator over any of the allocators above, e.g. to place
+	/// std::vector contents into an Arena.
+	//-------------------------------------------------------------------------------------------------
+	template <typename ValueType, typename AllocatorType = HeapAllocator>
+	class StlAllocator : private AllocatorType
+	{
+	public:
+		typedef ValueType			value_type;
+		typedef std::true_type		propagate_on_container_copy_assignment;
+		typedef std::true_type		propagate_on_container_move_assignment;
+		typedef std::true_type		propagate_on_container_swap;
+
+		template <typename OtherValueType>
+		class rebind
+		{
+		public:
+			typedef StlAllocator<OtherValueType, AllocatorType> other;
+		};
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline StlAllocator()
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline StlAllocator(const AllocatorType& allocator) : AllocatorType(allocator)
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename OtherValueType>
+		inline StlAllocator(const StlAllocator<OtherValueType, AllocatorType>& another) : AllocatorType(another.GetAllocator())
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline const AllocatorType& GetAllocator() const
+		{
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline ValueType* allocate(size_t elementsCount)
+		{
+			return static_cast<ValueType*>(AllocatorType::Allocate(sizeof(ValueType) * elementsCount, alignof(ValueType)));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void deallocate(ValueType* elements, size_t elementsCount)
+		{
+			AllocatorType::Deallocate(elements, sizeof(ValueType) * elementsCount);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename OtherValueType>
+		inline bool operator== (const StlAllocator<OtherValueType, AllocatorType>& another) const
+		{
+			return GetAllocator() == another.GetAllocator();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename OtherValueType>
+		inline bool operator!= (const StlAllocator<OtherValueType, AllocatorType>& another) const
+		{
+			return !(GetAllocator() == another.GetAllocator());
+		}
+	};
+}
@@ -0,0 +1,194 @@
+#include "platform.h"
+#include "Arena.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// Per-thread stack of released arena blocks, freed when the thread exits.
+	//-------------------------------------------------------------------------------------------------
+	class ArenaBlockCache
+	{
+	public:
+		static constexpr uint32_t	MaxBlocksCount = 16u;
+
+	public:
+		void*						m_blocks[MaxBlocksCount];
+		size_t						m_blockLengths[MaxBlocksCount];
+		uint32_t					m_blocksCount;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline ArenaBlockCache() : m_blocksCount(0u)
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline ~ArenaBlockCache()
+		{
+			while (m_blocksCount)
+			{
+				free(m_blocks[--m_blocksCount]);
+			}
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	static thread_local ArenaBlockCache	t_arenaBlockCache;
+	static thread_local Arena*			t_currentArena = nullptr;
+
+	//-------------------------------------------------------------------------------------------------
+	Arena::Arena(size_t blockLength, bool cacheBlocks) :
+		m_blocks(nullptr),
+		m_oversizedBlocks(nullptr),
+		m_current(nullptr),
+		m_end(nullptr),
+		m_blockLength(std::max(blockLength, sizeof(Block) * 4u)),
+		m_cacheBlocks(cacheBlocks)
+	{
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	Arena::~Arena()
+	{
+		Reset();
+
+		if (m_blocks)
+		{
+			ReleaseBlock(m_blocks, m_cacheBlocks);
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	void Arena::Reset()
+	{
+		while (m_oversizedBlocks)
+		{
+			Block* previousBlock = m_oversizedBlocks->m_previous;
+			ReleaseBlock(m_oversizedBlocks, false);
+			m_oversizedBlocks = previousBlock;
+		}
+
+		if (m_blocks == nullptr)
+		{
+			return;
+		}
+
+		while (m_blocks->m_previous)
+		{
+			Block* previousBlock = m_blocks->m_previous->m_previous;
+			ReleaseBlock(m_blocks->m_previous, m_cacheBlocks);
+			m_blocks->m_previous = previousBlock;
+		}
+
+		m_current = reinterpret_cast<byte*>(m_blocks + 1);
+		m_end = reinterpret_cast<byte*>(m_blocks) + m_blocks->m_length;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	size_t Arena::ReservedLength() const
+	{
+		size_t reservedLength = 0u;
+
+		for (const Block* block = m_blocks; block; block = block->m_previous)
+		{
+			reservedLength += block->m_length;
+		}
+
+		for (const Block* block = m_oversizedBlocks; block; block = block->m_previous)
+		{
+			reservedLength += block->m_length;
+		}
+
+		return reservedLength;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	Arena* Arena::Current()
+	{
+		return t_currentArena;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	void* Arena::AllocateSlow(size_t bytesCount, size_t alignment)
+	{
+		const size_t paddedLength = sizeof(Block) + bytesCount + alignment;
+
+		if (paddedLength > m_blockLength / 4u)
+		{
+			// Dedicated block, the current one keeps serving small allocations
+			Block* block = AcquireBlock(paddedLength, false);
+
+			block->m_previous = m_oversizedBlocks;
+			m_oversizedBlocks = block;
+
+			return reinterpret_cast<void*>((reinterpret_cast<uintptr_t>(block + 1) + alignment - 1u) & ~(alignment - 1u));
+		}
+
+		Block* block = AcquireBlock(m_blockLength, m_cacheBlocks);
+
+		block->m_previous = m_blocks;
+		m_blocks = block;
+
+		m_current = reinterpret_cast<byte*>(block + 1);
+		m_end = reinterpret_cast<byte*>(block) + block->m_length;
+
+		return Allocate(bytesCount, alignment);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	Arena::Block* Arena::AcquireBlock(size_t blockLength, bool cacheBlocks)
+	{
+		ArenaBlockCache& blockCache = t_arenaBlockCache;
+		void* memory;
+
+		if (cacheBlocks && blockCache.m_blocksCount && blockCache.m_blockLengths[blockCache.m_blocksCount - 1u] == blockLength)
+		{
+			memory = blockCache.m_blocks[--blockCache.m_blocksCount];
+		}
+		else
+		{
+			memory = malloc(blockLength);
+
+			if (memory == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+		}
+
+		Block* block = reinterpret_cast<Block*>(memory);
+
+		block->m_previous = nullptr;
+		block->m_length = blockLength;
+
+		return block;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	void Arena::ReleaseBlock(Block* block, bool cacheBlocks)
+	{
+		ArenaBlockCache& blockCache = t_arenaBlockCache;
+
+		if (cacheBlocks && blockCache.m_blocksCount != ArenaBlockCache::MaxBlocksCount)
+		{
+			blockCache.m_blockLengths[blockCache.m_blocksCount] = block->m_length;
+			blockCache.m_blocks[blockCache.m_blocksCount++] = block;
+		}
+		else
+		{
+			free(block);
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	ArenaScope::ArenaScope(Arena& arena) : m_previousArena(t_currentArena)
+	{
+		t_currentArena = &arena;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	ArenaScope::~ArenaScope()
+	{
+		t_currentArena = m_previousArena;
+	}
+}
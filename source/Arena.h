@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Allocators.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// Arena
+	///
+	/// Monotonic bump-pointer allocator for data which dies all at once, e.g. everything allocated while
+	/// serving one request. Deallocate() only gives memory back when it was the latest allocation,
+	/// the rest is reclaimed by Reset() or the destructor. Allocations bigger than a quarter of a block
+	/// get dedicated blocks. Released blocks of the regular length go to a small per-thread cache, so
+	/// arenas created for every request do not hit malloc. Not thread safe.
+	//-------------------------------------------------------------------------------------------------
+	class Arena : public boost::noncopyable
+	{
+	public:
+		static constexpr size_t		DefaultBlockLength = 64u << 10;
+
+	private:
+		class Block
+		{
+		public:
+			Block*					m_previous;
+			size_t					m_length;						///< in bytes, this header included
+		};
+
+	private:
+		Block*						m_blocks;						///< regular blocks, the current one first
+		Block*						m_oversizedBlocks;
+		byte*						m_current;
+		byte*						m_end;
+		const size_t				m_blockLength;
+		const bool					m_cacheBlocks;
+
+	public:
+		Arena(size_t blockLength = DefaultBlockLength, bool cacheBlocks = true);
+		~Arena();
+
+		/// Releases everything allocated so far, keeps the current block for reuse.
+		void Reset();
+
+		/// Bytes held in blocks, both used and not used yet.
+		size_t ReservedLength() const;
+
+		/// Arena installed on this thread by the innermost ArenaScope, or nullptr.
+		static Arena* Current();
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline void* Allocate(size_t bytesCount, size_t alignment)
+		{
+			const uintptr_t alignedCurrent = (reinterpret_cast<uintptr_t>(m_current) + alignment - 1u) & ~(alignment - 1u);
+
+			if (alignedCurrent <= reinterpret_cast<uintptr_t>(m_end) && bytesCount <= reinterpret_cast<uintptr_t>(m_end) - alignedCurrent)
+			{
+				m_current = reinterpret_cast<byte*>(alignedCurrent + bytesCount);
+				return reinterpret_cast<void*>(alignedCurrent);
+			}
+
+			return AllocateSlow(bytesCount, alignment);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Extends the latest allocation in place when the block has room for it.
+		inline void* Reallocate(void* memory, size_t oldBytesCount, size_t newBytesCount, size_t alignment)
+		{
+			byte* const memoryBytes = reinterpret_cast<byte*>(memory);
+
+			if (memoryBytes + oldBytesCount == m_current && newBytesCount <= static_cast<size_t>(m_end - memoryBytes))
+			{
+				m_current = memoryBytes + newBytesCount;
+				return memory;
+			}
+
+			void* newMemory = Allocate(newBytesCount, alignment);
+
+			memcpy(newMemory, memory, std::min(oldBytesCount, newBytesCount));
+
+			return newMemory;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void Deallocate(void* memory, size_t bytesCount)
+		{
+			byte* const memoryBytes = reinterpret_cast<byte*>(memory);
+
+			if (memoryBytes + bytesCount == m_current)
+			{
+				m_current = memoryBytes;
+			}
+		}
+
+	private:
+		void* AllocateSlow(size_t bytesCount, size_t alignment);
+
+		static Block* AcquireBlock(size_t blockLength, bool cacheBlocks);
+		static void ReleaseBlock(Block* block, bool cacheBlocks);
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// ArenaScope - makes an arena current for this thread, default constructed ArenaAllocator picks it.
+	//-------------------------------------------------------------------------------------------------
+	class ArenaScope : public boost::noncopyable
+	{
+	private:
+		Arena*						m_previousArena;
+
+	public:
+		ArenaScope(Arena& arena);
+		~ArenaScope();
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// ArenaAllocator
+	///
+	/// Allocator interface of HeapAllocator over an Arena. The arena is either given explicitly or
+	/// taken from the current ArenaScope at construction, without any it falls back to the heap.
+	//-------------------------------------------------------------------------------------------------
+	class ArenaAllocator
+	{
+	private:
+		Arena*						m_arena;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline ArenaAllocator() : m_arena(Arena::Current())
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline ArenaAllocator(Arena& arena) : m_arena(&arena)
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline Arena* GetArena() const
+		{
+			return m_arena;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void* Allocate(size_t bytesCount, size_t alignment)
+		{
+			return m_arena ? m_arena->Allocate(bytesCount, alignment) : HeapAllocator().Allocate(bytesCount, alignment);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void* Reallocate(void* memory, size_t oldBytesCount, size_t newBytesCount, size_t alignment)
+		{
+			return m_arena ? m_arena->Reallocate(memory, oldBytesCount, newBytesCount, alignment) : HeapAllocator().Reallocate(memory, oldBytesCount, newBytesCount, alignment);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void Deallocate(void* memory, size_t bytesCount)
+		{
+			if (m_arena)
+			{
+				m_arena->Deallocate(memory, bytesCount);
+			}
+			else
+			{
+				HeapAllocator().Deallocate(memory, bytesCount);
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool operator== (const ArenaAllocator& another) const
+		{
+			return m_arena == another.m_arena;
+		}
+	};
+}
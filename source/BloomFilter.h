@@ -0,0 +1,430 @@
+#pragma once
+
+#include "IStream.h"
+#include "Hash.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// BloomBlock
+	//-------------------------------------------------------------------------------------------------
+	template <uint32_t BlockWords>
+	class BloomBlock
+	{
+	public:
+		//---------------------------------------------------------------------------------------------
+		forceinline static void Set(uint64_t* block, const uint64_t* mask)
+		{
+			for (uint32_t wordIndex = 0u; wordIndex != BlockWords; wordIndex += 2u)
+			{
+				__m128i* blockPart = reinterpret_cast<__m128i*>(block + wordIndex);
+				_mm_store_si128(blockPart, _mm_or_si128(_mm_load_si128(blockPart), _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + wordIndex))));
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline static bool Test(const uint64_t* block, const uint64_t* mask)
+		{
+			__m128i missingBits = _mm_setzero_si128();
+
+			for (uint32_t wordIndex = 0u; wordIndex != BlockWords; wordIndex += 2u)
+			{
+				const __m128i blockPart = _mm_load_si128(reinterpret_cast<const __m128i*>(block + wordIndex));
+				const __m128i maskPart = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + wordIndex));
+
+				missingBits = _mm_or_si128(missingBits, _mm_andnot_si128(blockPart, maskPart));
+			}
+
+			return _mm_testz_si128(missingBits, missingBits) != 0;
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	template <>
+	class BloomBlock<1u>
+	{
+	public:
+		//---------------------------------------------------------------------------------------------
+		forceinline static void Set(uint64_t* block, const uint64_t* mask)
+		{
+			*block |= *mask;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline static bool Test(const uint64_t* block, const uint64_t* mask)
+		{
+			return (*block & *mask) == *mask;
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// BloomFilter
+	///
+	/// Blocked Bloom filter, every key touches exactly one block: with 8 words per block that is one
+	/// cache line (cache-blocked), with 1 word per block that is one register (register-blocked).
+	/// The block index and all probe positions come from a single 128 bit Murmur3 evaluation,
+	/// positions inside the block are produced by double hashing with an odd step, so they never repeat.
+	//-------------------------------------------------------------------------------------------------
+	template <uint32_t BlockWords = 8u>
+	class BloomFilter : public boost::noncopyable
+	{
+		static_assert(BlockWords == 1u || BlockWords == 2u || BlockWords == 4u || BlockWords == 8u, "Block must be a power of two words fitting a cache line.");
+
+	public:
+		static constexpr uint32_t	BlockBits = BlockWords * 64u;
+
+	private:
+		static constexpr uint32_t	SerializationTag = makefourcc('B', 'L', 'M', 'F');
+		static constexpr uint32_t	BatchLength = 16u;
+
+		class SerializedHeader
+		{
+		public:
+			uint32_t				m_tag;
+			uint32_t				m_blockWords;
+			uint64_t				m_blocksCount;
+			uint64_t				m_seed;
+			uint32_t				m_probesCount;
+			uint32_t				m_reserved;
+		};
+
+	private:
+		uint64_t*					m_words;
+		uint64_t					m_blocksCount;
+		uint64_t					m_seed;
+		uint32_t					m_probesCount;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline BloomFilter() : m_words(nullptr), m_blocksCount(0u), m_seed(1u), m_probesCount(0u)
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Throws std::bad_alloc if the bits can't be allocated.
+		inline BloomFilter(uint64_t bitsCount, uint32_t probesCount, uint64_t seed = 1u) : m_words(nullptr), m_blocksCount(0u), m_seed(seed), m_probesCount(probesCount)
+		{
+			assert(probesCount != 0u && probesCount <= BlockBits);
+
+			const uint64_t blocksCount = std::max<uint64_t>((bitsCount + BlockBits - 1u) / BlockBits, 1u);
+
+			m_words = AllocateWords(blocksCount);
+
+			if (m_words == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+
+			m_blocksCount = blocksCount;
+			Clear();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline ~BloomFilter()
+		{
+			free(m_words);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Bits required for the given false positive rate of a classic (non-blocked) filter.
+		inline static uint64_t OptimalBitsCount(uint64_t expectedItems, double falsePositiveRate)
+		{
+			return static_cast<uint64_t>(ceil(-static_cast<double>(expectedItems) * log(falsePositiveRate) / (M_LN2 * M_LN2)));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline static uint32_t OptimalProbesCount(uint64_t expectedItems, uint64_t bitsCount)
+		{
+			const double probesCount = round(static_cast<double>(bitsCount) / static_cast<double>(std::max<uint64_t>(expectedItems, 1u)) * M_LN2);
+
+			return static_cast<uint32_t>(std::min(std::max(probesCount, 1.0), static_cast<double>(BlockBits)));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint64_t BitsCount() const
+		{
+			return m_blocksCount * BlockBits;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint32_t ProbesCount() const
+		{
+			return m_probesCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void Clear()
+		{
+			memset(m_words, 0, m_blocksCount * BlockWords * sizeof(uint64_t));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void Insert(const void* key, uint64_t keyLength)
+		{
+			uint64_t lowHash, highHash;
+			Hash<uint64_t>::Calculate128(key, keyLength, m_seed, lowHash, highHash);
+
+			InsertHashed(lowHash, highHash);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool Contains(const void* key, uint64_t keyLength) const
+		{
+			uint64_t lowHash, highHash;
+			Hash<uint64_t>::Calculate128(key, keyLength, m_seed, lowHash, highHash);
+
+			return ContainsHashed(lowHash, highHash);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		inline void Insert(const KeyType& key)
+		{
+			uint64_t lowHash, highHash;
+			HashKey(key, lowHash, highHash);
+
+			InsertHashed(lowHash, highHash);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		inline bool Contains(const KeyType& key) const
+		{
+			uint64_t lowHash, highHash;
+			HashKey(key, lowHash, highHash);
+
+			return ContainsHashed(lowHash, highHash);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Hashes keys in small batches and prefetches their blocks before touching them.
+		template <typename KeyType>
+		inline void InsertBulk(const KeyType* keys, uint64_t keysCount)
+		{
+			uint64_t blockIndices[BatchLength];
+			uint64_t probeHashes[BatchLength];
+
+			for (uint64_t batchStart = 0u; batchStart < keysCount; batchStart += BatchLength)
+			{
+				const uint32_t batchLength = static_cast<uint32_t>(std::min<uint64_t>(keysCount - batchStart, BatchLength));
+
+				PrepareBatch(keys + batchStart, batchLength, blockIndices, probeHashes);
+
+				for (uint32_t keyIndex = 0u; keyIndex != batchLength; ++keyIndex)
+				{
+					uint64_t mask[BlockWords];
+					BuildMask(probeHashes[keyIndex], mask);
+
+					BloomBlock<BlockWords>::Set(m_words + blockIndices[keyIndex] * BlockWords, mask);
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Returns the number of keys reported as present.
+		template <typename KeyType>
+		inline uint64_t ContainsBulk(const KeyType* keys, uint64_t keysCount, bool* results) const
+		{
+			uint64_t blockIndices[BatchLength];
+			uint64_t probeHashes[BatchLength];
+			uint64_t presentCount = 0u;
+
+			for (uint64_t batchStart = 0u; batchStart < keysCount; batchStart += BatchLength)
+			{
+				const uint32_t batchLength = static_cast<uint32_t>(std::min<uint64_t>(keysCount - batchStart, BatchLength));
+
+				PrepareBatch(keys + batchStart, batchLength, blockIndices, probeHashes);
+
+				for (uint32_t keyIndex = 0u; keyIndex != batchLength; ++keyIndex)
+				{
+					uint64_t mask[BlockWords];
+					BuildMask(probeHashes[keyIndex], mask);
+
+					const bool present = BloomBlock<BlockWords>::Test(m_words + blockIndices[keyIndex] * BlockWords, mask);
+
+					results[batchStart + keyIndex] = present;
+					presentCount += present;
+				}
+			}
+
+			return presentCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Unites with a filter of the same geometry and seed, returns false if they differ.
+		inline bool Merge(const BloomFilter& another)
+		{
+			if (m_blocksCount != another.m_blocksCount || m_probesCount != another.m_probesCount || m_seed != another.m_seed)
+			{
+				return false;
+			}
+
+			const uint64_t wordsCount = m_blocksCount * BlockWords;
+			uint64_t wordIndex = 0u;
+
+			for (; wordIndex + 2u <= wordsCount; wordIndex += 2u)
+			{
+				__m128i* thisPart = reinterpret_cast<__m128i*>(m_words + wordIndex);
+				_mm_store_si128(thisPart, _mm_or_si128(_mm_load_si128(thisPart), _mm_load_si128(reinterpret_cast<const __m128i*>(another.m_words + wordIndex))));
+			}
+
+			for (; wordIndex != wordsCount; ++wordIndex)
+			{
+				m_words[wordIndex] |= another.m_words[wordIndex];
+			}
+
+			return true;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool Save(IStream& outputStream) const
+		{
+			const SerializedHeader header = { SerializationTag, BlockWords, m_blocksCount, m_seed, m_probesCount, 0u };
+			const IStream::StreamPos wordsLength = m_blocksCount * BlockWords * sizeof(uint64_t);
+
+			return outputStream.Write(&header, sizeof(header)) == sizeof(header) && outputStream.Write(m_words, wordsLength) == wordsLength;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// The filter is replaced only once the whole body has been read, a header asking for more
+		/// bits than the stream has left or than can be allocated fails the load.
+		inline bool Load(IStream& inputStream)
+		{
+			SerializedHeader header;
+
+			if (inputStream.Read(reinterpret_cast<byte*>(&header), sizeof(header)) != sizeof(header) ||
+				header.m_tag != SerializationTag || header.m_blockWords != BlockWords || header.m_blocksCount == 0u ||
+				header.m_probesCount == 0u || header.m_probesCount > BlockBits)
+			{
+				return false;
+			}
+
+			const IStream::StreamPos position = inputStream.Tell();
+			const IStream::StreamPos remainingLength = inputStream.Length() - std::min(position, inputStream.Length());
+
+			if (header.m_blocksCount > remainingLength / (BlockWords * sizeof(uint64_t)))
+			{
+				return false;
+			}
+
+			const IStream::StreamPos wordsLength = header.m_blocksCount * BlockWords * sizeof(uint64_t);
+			uint64_t* words = AllocateWords(header.m_blocksCount);
+
+			if (words == nullptr)
+			{
+				return false;
+			}
+
+			if (inputStream.Read(reinterpret_cast<byte*>(words), wordsLength) != wordsLength)
+			{
+				free(words);
+				return false;
+			}
+
+			free(m_words);
+
+			m_words = words;
+			m_blocksCount = header.m_blocksCount;
+			m_seed = header.m_seed;
+			m_probesCount = header.m_probesCount;
+
+			return true;
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		/// Returns nullptr on failure, including sizes not fitting the address space.
+		inline static uint64_t* AllocateWords(uint64_t blocksCount)
+		{
+			void* words = nullptr;
+
+			if (blocksCount > std::numeric_limits<size_t>::max() / (BlockWords * sizeof(uint64_t)) ||
+				posix_memalign(&words, 64u, blocksCount * BlockWords * sizeof(uint64_t)) != 0)
+			{
+				return nullptr;
+			}
+
+			return reinterpret_cast<uint64_t*>(words);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline void HashKey(const char* key, uint64_t& lowHash, uint64_t& highHash) const
+		{
+			Hash<uint64_t>::Calculate128(key, strlen(key), m_seed, lowHash, highHash);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline void HashKey(const std::string& key, uint64_t& lowHash, uint64_t& highHash) const
+		{
+			Hash<uint64_t>::Calculate128(key.data(), key.size(), m_seed, lowHash, highHash);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		forceinline void HashKey(const KeyType& key, uint64_t& lowHash, uint64_t& highHash) const
+		{
+			Hash<uint64_t>::Calculate128(&key, sizeof(KeyType), m_seed, lowHash, highHash);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline uint64_t BlockIndex(uint64_t lowHash) const
+		{
+			return static_cast<uint64_t>((static_cast<unsigned __int128>(lowHash) * m_blocksCount) >> 64);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline void BuildMask(uint64_t probeHash, uint64_t (&mask)[BlockWords]) const
+		{
+			const uint32_t probeStep = static_cast<uint32_t>(probeHash >> 32) | 1u;
+			uint32_t probePosition = static_cast<uint32_t>(probeHash);
+
+			for (uint32_t wordIndex = 0u; wordIndex != BlockWords; ++wordIndex)
+			{
+				mask[wordIndex] = 0u;
+			}
+
+			for (uint32_t probeIndex = 0u; probeIndex != m_probesCount; ++probeIndex, probePosition += probeStep)
+			{
+				const uint32_t bitIndex = probePosition & (BlockBits - 1u);
+				mask[bitIndex >> 6] |= uint64_t(1u) << (bitIndex & 63u);
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		forceinline void PrepareBatch(const KeyType* keys, uint32_t batchLength, uint64_t* blockIndices, uint64_t* probeHashes) const
+		{
+			for (uint32_t keyIndex = 0u; keyIndex != batchLength; ++keyIndex)
+			{
+				uint64_t lowHash;
+				HashKey(keys[keyIndex], lowHash, probeHashes[keyIndex]);
+
+				blockIndices[keyIndex] = BlockIndex(lowHash);
+				_mm_prefetch(reinterpret_cast<const char*>(m_words + blockIndices[keyIndex] * BlockWords), _MM_HINT_T0);
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline void InsertHashed(uint64_t lowHash, uint64_t highHash)
+		{
+			uint64_t mask[BlockWords];
+			BuildMask(highHash, mask);
+
+			BloomBlock<BlockWords>::Set(m_words + BlockIndex(lowHash) * BlockWords, mask);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline bool ContainsHashed(uint64_t lowHash, uint64_t highHash) const
+		{
+			uint64_t mask[BlockWords];
+			BuildMask(highHash, mask);
+
+			return BloomBlock<BlockWords>::Test(m_words + BlockIndex(lowHash) * BlockWords, mask);
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	typedef BloomFilter<8u> CacheBlockedBloomFilter;
+	typedef BloomFilter<1u> RegisterBlockedBloomFilter;
+}
@@ -1,44 +1,57 @@
 #pragma once
 
 #include "IStream.h"
+#include "Allocators.h"
 
 
 namespace aux
 {
 	//-------------------------------------------------------------------------------------------------
 	/// ChunkedStorage
+	///
+	/// Chunks come from AllocatorType, with ArenaAllocator the whole storage is released by the arena.
+	/// Lengths are counted in SizeType, uint64_t allows storages of more than 4G items.
 	//-------------------------------------------------------------------------------------------------
-	template <typename DataType>
+	template <typename DataType, typename AllocatorType = HeapAllocator, typename SizeType = uint32_t>
 	class ChunkedStorage : public boost::noncopyable
 	{
+		static_assert(std::is_trivially_copyable<DataType>::value, "Chunks are merged as raw bytes.");
+		static_assert(std::is_integral<SizeType>::value && std::is_unsigned<SizeType>::value, "SizeType must be an unsigned integer.");
+
 	private:
 		class Chunk
 		{
 		public:
 			DataType*					m_chunkData;
-			uint32_t					m_chunkFullness;			///< in DataType items; efficient length is usually smaller than total chunk length
+			SizeType					m_chunkFullness;			///< in DataType items; efficient length is usually smaller than total chunk length
+			SizeType					m_chunkLength;				///< in DataType items
 
 		public:
-			inline Chunk(DataType* chunkData, uint32_t chunkFullness) : m_chunkData(chunkData), m_chunkFullness(chunkFullness) {}
+			inline Chunk(DataType* chunkData, SizeType chunkFullness, SizeType chunkLength) : m_chunkData(chunkData), m_chunkFullness(chunkFullness), m_chunkLength(chunkLength) {}
 		};
 
-		typedef std::vector<Chunk> ChunkVector;
+		typedef std::vector<Chunk, StlAllocator<Chunk, AllocatorType> > ChunkVector;
 
 	private:
+		AllocatorType				m_allocator;
 		ChunkVector					m_chunkVector;
-		const uint32_t				m_defaultChunkLength;			///< in DataType items
-		uint32_t					m_totalDataLength;				///< in DataType items
+		const SizeType				m_defaultChunkLength;			///< in DataType items
+		SizeType					m_totalDataLength;				///< in DataType items
 		DataType*					m_currentChunkData;
-		uint32_t					m_currentChunkFullness;			///< in DataType items
+		SizeType					m_currentChunkFullness;			///< in DataType items
+		SizeType					m_currentChunkLength;			///< in DataType items
 
 	public:
 		//---------------------------------------------------------------------------------------------
-		inline ChunkedStorage(uint32_t defaultChunkLength = 4096u) :
+		inline ChunkedStorage(SizeType defaultChunkLength = 4096u, const AllocatorType& allocator = AllocatorType()) :
+			m_allocator(allocator),
+			m_chunkVector(StlAllocator<Chunk, AllocatorType>(allocator)),
 			m_defaultChunkLength(defaultChunkLength),
 			m_totalDataLength(0u)
 		{
-			m_currentChunkData = new DataType[m_defaultChunkLength];
+			m_currentChunkData = AllocateChunkData(m_defaultChunkLength);
 			m_currentChunkFullness = 0u;
+			m_currentChunkLength = m_defaultChunkLength;
 		}
 
 		//---------------------------------------------------------------------------------------------
@@ -46,27 +59,28 @@ namespace aux
 		{
 			for (auto& chunk : m_chunkVector)
 			{
-				delete[] chunk.m_chunkData;
+				DeallocateChunkData(chunk.m_chunkData, chunk.m_chunkLength);
 			}
 
-			delete[] m_currentChunkData;
+			DeallocateChunkData(m_currentChunkData, m_currentChunkLength);
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline void AllocateChunk(uint32_t chunkLength)
+		inline void AllocateChunk(SizeType chunkLength)
 		{
 			if (m_currentChunkFullness == 0u)
 			{
-				delete[] m_currentChunkData;
+				DeallocateChunkData(m_currentChunkData, m_currentChunkLength);
 			}
 			else
 			{
-				m_chunkVector.emplace_back(Chunk(m_currentChunkData, m_currentChunkFullness));
+				m_chunkVector.emplace_back(Chunk(m_currentChunkData, m_currentChunkFullness, m_currentChunkLength));
 				m_totalDataLength += m_currentChunkFullness;
 			}
 
-			m_currentChunkData = new DataType[chunkLength];
+			m_currentChunkData = AllocateChunkData(chunkLength);
 			m_currentChunkFullness = 0u;
+			m_currentChunkLength = chunkLength;
 		}
 
 		//---------------------------------------------------------------------------------------------
@@ -92,16 +106,32 @@ namespace aux
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline void GetWriteBuffer(DataType**& bufferData, uint32_t*& bufferFullness)
+		inline void GetWriteBuffer(DataType**& bufferData, SizeType*& bufferFullness)
 		{
 			bufferData = &m_currentChunkData;
 			bufferFullness = &m_currentChunkFullness;
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline uint32_t GetWriteBufferLength() const
+		inline SizeType GetWriteBufferLength() const
 		{
 			return m_defaultChunkLength;
 		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		inline DataType* AllocateChunkData(SizeType chunkLength)
+		{
+			return chunkLength ? static_cast<DataType*>(m_allocator.Allocate(sizeof(DataType) * chunkLength, alignof(DataType))) : nullptr;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void DeallocateChunkData(DataType* chunkData, SizeType chunkLength)
+		{
+			if (chunkData)
+			{
+				m_allocator.Deallocate(chunkData, sizeof(DataType) * chunkLength);
+			}
+		}
 	};
 }
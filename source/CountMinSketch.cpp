@@ -0,0 +1,136 @@
+#include "platform.h"
+#include "CountMinSketch.h"
+#include "Miscellaneous.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	CountMinSketch::CountMinSketch() : m_counters(nullptr), m_width(0u), m_widthShift(64u), m_depth(0u), m_seed(1u)
+	{
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	CountMinSketch::CountMinSketch(uint64_t width, uint32_t depth, uint64_t seed) : m_seed(seed)
+	{
+		assert(depth != 0u);
+
+		m_width = NextPowerOfTwo<uint64_t>(std::max<uint64_t>(width, 2u));
+		m_widthShift = 64u - static_cast<uint32_t>(__builtin_ctzll(m_width));
+		m_depth = depth;
+		m_counters = new uint32_t[m_width * m_depth];
+
+		Clear();
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	CountMinSketch::~CountMinSketch()
+	{
+		delete[] m_counters;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	uint64_t CountMinSketch::OptimalWidth(double epsilon)
+	{
+		return static_cast<uint64_t>(ceil(M_E / epsilon));
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	uint32_t CountMinSketch::OptimalDepth(double delta)
+	{
+		return std::max(static_cast<uint32_t>(ceil(log(1.0 / delta))), 1u);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	void CountMinSketch::Clear()
+	{
+		memset(m_counters, 0, m_width * m_depth * sizeof(uint32_t));
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	bool CountMinSketch::Merge(const CountMinSketch& another)
+	{
+		if (m_width != another.m_width || m_depth != another.m_depth || m_seed != another.m_seed)
+		{
+			return false;
+		}
+
+		const uint64_t countersCount = m_width * m_depth;
+		const __m128i allBits = _mm_set1_epi32(-1);
+
+		uint64_t counterIndex = 0u;
+
+		for (; counterIndex + 4u <= countersCount; counterIndex += 4u)
+		{
+			__m128i* thisCounters = reinterpret_cast<__m128i*>(m_counters + counterIndex);
+			const __m128i counters = _mm_loadu_si128(thisCounters);
+			const __m128i anotherCounters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(another.m_counters + counterIndex));
+
+			// counter + min(count, ~counter) never wraps around
+			_mm_storeu_si128(thisCounters, _mm_add_epi32(counters, _mm_min_epu32(anotherCounters, _mm_xor_si128(counters, allBits))));
+		}
+
+		for (; counterIndex != countersCount; ++counterIndex)
+		{
+			m_counters[counterIndex] = SaturatingAdd(m_counters[counterIndex], another.m_counters[counterIndex]);
+		}
+
+		return true;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	bool CountMinSketch::Save(IStream& outputStream) const
+	{
+		const SerializedHeader header = { SerializationTag, m_depth, m_width, m_seed };
+		const IStream::StreamPos countersLength = m_width * m_depth * sizeof(uint32_t);
+
+		return outputStream.Write(&header, sizeof(header)) == sizeof(header) && outputStream.Write(m_counters, countersLength) == countersLength;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// The sketch is replaced only once the whole body has been read.
+	bool CountMinSketch::Load(IStream& inputStream)
+	{
+		SerializedHeader header;
+
+		if (inputStream.Read(reinterpret_cast<byte*>(&header), sizeof(header)) != sizeof(header) ||
+			header.m_tag != SerializationTag || header.m_depth == 0u || header.m_width < 2u || (header.m_width & (header.m_width - 1u)) != 0u)
+		{
+			return false;
+		}
+
+		// Bounding by the bytes left keeps a corrupt header from overflowing the size or allocating
+		// more than can be read
+		const IStream::StreamPos position = inputStream.Tell();
+		const IStream::StreamPos remainingLength = inputStream.Length() - std::min(position, inputStream.Length());
+
+		if (header.m_width > remainingLength / sizeof(uint32_t) / header.m_depth)
+		{
+			return false;
+		}
+
+		const IStream::StreamPos countersLength = header.m_width * header.m_depth * sizeof(uint32_t);
+		uint32_t* counters = new (std::nothrow) uint32_t[header.m_width * header.m_depth];
+
+		if (counters == nullptr)
+		{
+			return false;
+		}
+
+		if (inputStream.Read(reinterpret_cast<byte*>(counters), countersLength) != countersLength)
+		{
+			delete[] counters;
+			return false;
+		}
+
+		delete[] m_counters;
+
+		m_counters = counters;
+		m_width = header.m_width;
+		m_widthShift = 64u - static_cast<uint32_t>(__builtin_ctzll(m_width));
+		m_depth = header.m_depth;
+		m_seed = header.m_seed;
+
+		return true;
+	}
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "IStream.h"
+#include "Hash.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// CountMinSketch
+	///
+	/// Frequency estimator with saturating 32 bit counters. Column of every row is derived from
+	/// a single 128 bit Murmur3 evaluation by double hashing: column(row) = top bits of (h1 + row * h2).
+	//-------------------------------------------------------------------------------------------------
+	class CountMinSketch : public boost::noncopyable
+	{
+	private:
+		static constexpr uint32_t	SerializationTag = makefourcc('C', 'M', 'S', 'K');
+		static constexpr uint32_t	BatchLength = 16u;
+
+		class SerializedHeader
+		{
+		public:
+			uint32_t				m_tag;
+			uint32_t				m_depth;
+			uint64_t				m_width;
+			uint64_t				m_seed;
+		};
+
+	private:
+		uint32_t*					m_counters;						///< depth rows of width counters each
+		uint64_t					m_width;
+		uint32_t					m_widthShift;
+		uint32_t					m_depth;
+		uint64_t					m_seed;
+
+	public:
+		CountMinSketch();
+		CountMinSketch(uint64_t width, uint32_t depth, uint64_t seed = 1u);
+		~CountMinSketch();
+
+		/// Width for the estimation error of epsilon * total count.
+		static uint64_t OptimalWidth(double epsilon);
+
+		/// Depth for the probability delta of exceeding the estimation error.
+		static uint32_t OptimalDepth(double delta);
+
+		void Clear();
+
+		/// Adds counters of a sketch with the same geometry and seed, returns false if they differ.
+		bool Merge(const CountMinSketch& another);
+
+		bool Save(IStream& outputStream) const;
+		bool Load(IStream& inputStream);
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline uint64_t Width() const
+		{
+			return m_width;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint32_t Depth() const
+		{
+			return m_depth;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		inline void Add(const KeyType& key, uint32_t count = 1u)
+		{
+			uint64_t lowHash, highHash;
+			HashKey(key, lowHash, highHash);
+
+			AddHashed(lowHash, highHash, count);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Conservative update: raises only the counters that are below the new estimate, which
+		/// noticeably reduces overestimation for skewed streams; the result is no longer mergeable exactly.
+		template <typename KeyType>
+		inline void AddConservative(const KeyType& key, uint32_t count = 1u)
+		{
+			uint64_t lowHash, highHash;
+			HashKey(key, lowHash, highHash);
+
+			const uint32_t newEstimate = SaturatingAdd(EstimateHashed(lowHash, highHash), count);
+			uint64_t columnHash = lowHash;
+
+			for (uint32_t rowIndex = 0u; rowIndex != m_depth; ++rowIndex, columnHash += highHash)
+			{
+				uint32_t& counter = m_counters[rowIndex * m_width + (columnHash >> m_widthShift)];
+				counter = std::max(counter, newEstimate);
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		inline uint32_t Estimate(const KeyType& key) const
+		{
+			uint64_t lowHash, highHash;
+			HashKey(key, lowHash, highHash);
+
+			return EstimateHashed(lowHash, highHash);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Hashes keys in small batches and prefetches all their counters before touching them.
+		template <typename KeyType>
+		inline void AddBulk(const KeyType* keys, uint64_t keysCount, uint32_t count = 1u)
+		{
+			uint64_t lowHashes[BatchLength];
+			uint64_t highHashes[BatchLength];
+
+			for (uint64_t batchStart = 0u; batchStart < keysCount; batchStart += BatchLength)
+			{
+				const uint32_t batchLength = static_cast<uint32_t>(std::min<uint64_t>(keysCount - batchStart, BatchLength));
+
+				PrepareBatch(keys + batchStart, batchLength, lowHashes, highHashes);
+
+				for (uint32_t keyIndex = 0u; keyIndex != batchLength; ++keyIndex)
+				{
+					AddHashed(lowHashes[keyIndex], highHashes[keyIndex], count);
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		inline void EstimateBulk(const KeyType* keys, uint64_t keysCount, uint32_t* estimates) const
+		{
+			uint64_t lowHashes[BatchLength];
+			uint64_t highHashes[BatchLength];
+
+			for (uint64_t batchStart = 0u; batchStart < keysCount; batchStart += BatchLength)
+			{
+				const uint32_t batchLength = static_cast<uint32_t>(std::min<uint64_t>(keysCount - batchStart, BatchLength));
+
+				PrepareBatch(keys + batchStart, batchLength, lowHashes, highHashes);
+
+				for (uint32_t keyIndex = 0u; keyIndex != batchLength; ++keyIndex)
+				{
+					estimates[batchStart + keyIndex] = EstimateHashed(lowHashes[keyIndex], highHashes[keyIndex]);
+				}
+			}
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		forceinline static uint32_t SaturatingAdd(uint32_t counter, uint32_t count)
+		{
+			return counter + std::min(count, ~counter);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline void HashKey(const char* key, uint64_t& lowHash, uint64_t& highHash) const
+		{
+			Hash<uint64_t>::Calculate128(key, strlen(key), m_seed, lowHash, highHash);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline void HashKey(const std::string& key, uint64_t& lowHash, uint64_t& highHash) const
+		{
+			Hash<uint64_t>::Calculate128(key.data(), key.size(), m_seed, lowHash, highHash);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		forceinline void HashKey(const KeyType& key, uint64_t& lowHash, uint64_t& highHash) const
+		{
+			Hash<uint64_t>::Calculate128(&key, sizeof(KeyType), m_seed, lowHash, highHash);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		forceinline void PrepareBatch(const KeyType* keys, uint32_t batchLength, uint64_t* lowHashes, uint64_t* highHashes) const
+		{
+			for (uint32_t keyIndex = 0u; keyIndex != batchLength; ++keyIndex)
+			{
+				HashKey(keys[keyIndex], lowHashes[keyIndex], highHashes[keyIndex]);
+
+				uint64_t columnHash = lowHashes[keyIndex];
+
+				for (uint32_t rowIndex = 0u; rowIndex != m_depth; ++rowIndex, columnHash += highHashes[keyIndex])
+				{
+					_mm_prefetch(reinterpret_cast<const char*>(m_counters + rowIndex * m_width + (columnHash >> m_widthShift)), _MM_HINT_T0);
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline void AddHashed(uint64_t lowHash, uint64_t highHash, uint32_t count)
+		{
+			uint64_t columnHash = lowHash;
+
+			for (uint32_t rowIndex = 0u; rowIndex != m_depth; ++rowIndex, columnHash += highHash)
+			{
+				uint32_t& counter = m_counters[rowIndex * m_width + (columnHash >> m_widthShift)];
+				counter = SaturatingAdd(counter, count);
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline uint32_t EstimateHashed(uint64_t lowHash, uint64_t highHash) const
+		{
+			uint32_t estimate = std::numeric_limits<uint32_t>::max();
+			uint64_t columnHash = lowHash;
+
+			for (uint32_t rowIndex = 0u; rowIndex != m_depth; ++rowIndex, columnHash += highHash)
+			{
+				estimate = std::min(estimate, m_counters[rowIndex * m_width + (columnHash >> m_widthShift)]);
+			}
+
+			return estimate;
+		}
+	};
+}
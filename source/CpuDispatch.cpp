@@ -0,0 +1,144 @@
+#include "platform.h"
+#include "CpuDispatch.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	std::atomic<uint32_t>			CpuDispatch::s_level(CpuDispatch::UnknownLevel);
+
+	//-------------------------------------------------------------------------------------------------
+	static uint32_t DetectFeatures()
+	{
+		uint32_t eax = 0u, ebx = 0u, ecx = 0u, edx = 0u;
+		uint32_t features = 0u;
+
+		if (!__get_cpuid(1u, &eax, &ebx, &ecx, &edx))
+		{
+			return features;
+		}
+
+		features |= (ecx & bit_SSE4_1) ? CpuDispatch::Sse41 : 0u;
+		features |= (ecx & bit_SSE4_2) ? CpuDispatch::Sse42 : 0u;
+
+		// AVX registers are usable only when the OS saves their state, XCR0 bits 1 (SSE) and 2 (AVX)
+		if ((ecx & bit_OSXSAVE) == 0u)
+		{
+			return features;
+		}
+
+		uint32_t xcr0Low = 0u, xcr0High = 0u;
+		__asm__ volatile ("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0u));
+
+		if ((xcr0Low & 0x06u) != 0x06u || (ecx & bit_AVX) == 0u)
+		{
+			return features;
+		}
+
+		features |= CpuDispatch::Avx;
+		features |= (ecx & bit_FMA) ? CpuDispatch::Fma : 0u;
+		features |= (ecx & bit_F16C) ? CpuDispatch::F16c : 0u;
+
+		if (__get_cpuid_count(7u, 0u, &eax, &ebx, &ecx, &edx))
+		{
+			features |= (ebx & bit_AVX2) ? CpuDispatch::Avx2 : 0u;
+			features |= (ebx & bit_BMI2) ? CpuDispatch::Bmi2 : 0u;
+
+			// AVX-512 also needs the opmask and upper ZMM state, XCR0 bits 5 to 7
+			features |= ((ebx & bit_AVX512F) && (xcr0Low & 0xE0u) == 0xE0u) ? CpuDispatch::Avx512f : 0u;
+		}
+
+		return features;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	uint32_t CpuDispatch::Features()
+	{
+		static const uint32_t features = DetectFeatures();
+
+		return features;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	IsaLevel CpuDispatch::SupportedLevel()
+	{
+		const uint32_t features = Features();
+
+		if ((features & (Avx2 | Fma | F16c)) == (Avx2 | Fma | F16c))
+		{
+			return IsaLevel::Avx2;
+		}
+
+		if (features & Avx)
+		{
+			return IsaLevel::Avx;
+		}
+
+		return IsaLevel::Sse41;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	bool CpuDispatch::ForceLevel(IsaLevel level)
+	{
+		if (level > SupportedLevel())
+		{
+			return false;
+		}
+
+		s_level.store(static_cast<uint32_t>(level), std::memory_order_relaxed);
+
+		return true;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	bool CpuDispatch::ParseLevel(const char* levelName, IsaLevel& level)
+	{
+		for (uint32_t levelIndex = 0u; levelIndex != IsaLevelsCount; ++levelIndex)
+		{
+			if (strcasecmp(levelName, LevelName(static_cast<IsaLevel>(levelIndex))) == 0)
+			{
+				level = static_cast<IsaLevel>(levelIndex);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	const char* CpuDispatch::LevelName(IsaLevel level)
+	{
+		switch (level)
+		{
+		case IsaLevel::Sse41:
+			return "sse4.1";
+
+		case IsaLevel::Avx:
+			return "avx";
+
+		case IsaLevel::Avx2:
+			return "avx2";
+		}
+
+		return "unknown";
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	IsaLevel CpuDispatch::InitializeLevel()
+	{
+		IsaLevel level = SupportedLevel();
+		IsaLevel requestedLevel;
+		const char* requestedLevelName = getenv("AUX_ISA_LEVEL");
+
+		if (requestedLevelName && ParseLevel(requestedLevelName, requestedLevel))
+		{
+			level = std::min(level, requestedLevel);
+		}
+
+		// Keeps a level forced meanwhile by another thread
+		uint32_t expectedLevel = UnknownLevel;
+		s_level.compare_exchange_strong(expectedLevel, static_cast<uint32_t>(level), std::memory_order_relaxed);
+
+		return static_cast<IsaLevel>(s_level.load(std::memory_order_relaxed));
+	}
+}
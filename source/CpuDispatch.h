@@ -0,0 +1,75 @@
+#pragma once
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// IsaLevel - instruction set levels vector kernels are compiled for, each includes the previous
+	//-------------------------------------------------------------------------------------------------
+	enum class IsaLevel : uint32_t
+	{
+		Sse41 = 0u,						///< baseline the library is compiled with
+		Avx,
+		Avx2
+	};
+
+	constexpr uint32_t				IsaLevelsCount = 3u;
+
+	//-------------------------------------------------------------------------------------------------
+	/// CpuDispatch
+	///
+	/// Detects the CPU features with CPUID (and XGETBV for the OS support of AVX state) once, and
+	/// selects the highest IsaLevel both the CPU and the library support. Kernels compiled for several
+	/// levels keep a table per level and index it with Level(). The AUX_ISA_LEVEL environment
+	/// variable ("sse4.1", "avx", "avx2") or ForceLevel() lowers the level, e.g. to test every path
+	/// on one machine.
+	//-------------------------------------------------------------------------------------------------
+	class CpuDispatch
+	{
+	public:
+		enum Feature : uint32_t
+		{
+			Sse41 = 1u << 0,
+			Sse42 = 1u << 1,
+			Avx = 1u << 2,
+			Avx2 = 1u << 3,
+			Fma = 1u << 4,
+			F16c = 1u << 5,
+			Bmi2 = 1u << 6,
+			Avx512f = 1u << 7
+		};
+
+	private:
+		static constexpr uint32_t	UnknownLevel = ~0u;
+
+		static std::atomic<uint32_t>	s_level;
+
+	public:
+		/// Feature bits of the CPU.
+		static uint32_t Features();
+
+		/// Highest level supported by the CPU.
+		static IsaLevel SupportedLevel();
+
+		/// Sets the active level, returns false when the CPU does not support it.
+		static bool ForceLevel(IsaLevel level);
+
+		/// Parses "sse4.1", "avx" or "avx2".
+		static bool ParseLevel(const char* levelName, IsaLevel& level);
+
+		static const char* LevelName(IsaLevel level);
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		/// Active level.
+		inline static IsaLevel Level()
+		{
+			const uint32_t level = s_level.load(std::memory_order_relaxed);
+
+			return level != UnknownLevel ? static_cast<IsaLevel>(level) : InitializeLevel();
+		}
+
+	private:
+		static IsaLevel InitializeLevel();
+	};
+}
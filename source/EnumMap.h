@@ -0,0 +1,194 @@
+#pragma once
+
+#include "Hash.h"
+#include "Miscellaneous.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// EnumMapEntry
+	//-------------------------------------------------------------------------------------------------
+	template <typename EnumType>
+	class EnumMapEntry
+	{
+	public:
+		const char*					m_name;
+		uint32_t					m_nameLength;
+		EnumType					m_value;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		constexpr EnumMapEntry() : m_name(""), m_nameLength(0u), m_value()
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <size_t NameSize>
+		constexpr EnumMapEntry(const char (&name)[NameSize], EnumType value) : m_name(name), m_nameLength(NameSize - 1u), m_value(value)
+		{
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// EnumMap
+	///
+	/// Perfect-hash string <-> enum table built at compile time:
+	///
+	///		static constexpr aux::EnumMapEntry<Color> colorEntries[] = { { "red", Color::Red }, { "green", Color::Green } };
+	///		static constexpr auto colorMap = aux::MakeEnumMap(colorEntries);
+	///
+	/// Parsing costs one Hash32() of the input, one multiplicative displacement and one compare.
+	/// Entries are spread into buckets by the low bits of their hash, every bucket gets an odd
+	/// multiplier that scatters its entries into distinct slots (hash-and-displace scheme).
+	//-------------------------------------------------------------------------------------------------
+	template <typename EnumType, uint32_t EntriesCount>
+	class EnumMap
+	{
+	public:
+		static constexpr uint32_t	SlotsCount = NextPowerOfTwo(EntriesCount * 2u);
+		static constexpr uint32_t	BucketsCount = NextPowerOfTwo((EntriesCount + 1u) / 2u);
+
+	private:
+		static constexpr uint32_t	MaxDisplacementAttempts = 0x10000u;
+
+	private:
+		EnumMapEntry<EnumType>		m_entries[EntriesCount];
+		uint32_t					m_multipliers[BucketsCount];	///< odd multiplier per bucket
+		uint32_t					m_slots[SlotsCount];			///< entry index + 1, zero marks an empty slot
+		uint32_t					m_slotShift;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		constexpr EnumMap(const EnumMapEntry<EnumType> (&entries)[EntriesCount]) : m_entries{}, m_multipliers{}, m_slots{}, m_slotShift(32u)
+		{
+			static_assert(EntriesCount != 0u, "Enum map can't be empty.");
+
+			uint32_t entryHashes[EntriesCount] = {};
+			uint32_t bucketSizes[BucketsCount] = {};
+			uint32_t maxBucketSize = 0u;
+
+			for (uint32_t slotsCount = SlotsCount; slotsCount != 1u; slotsCount >>= 1)
+			{
+				--m_slotShift;
+			}
+
+			for (uint32_t entryIndex = 0u; entryIndex != EntriesCount; ++entryIndex)
+			{
+				m_entries[entryIndex] = entries[entryIndex];
+				entryHashes[entryIndex] = Hash<uint32_t>::StaticCalculate(entries[entryIndex].m_name, entries[entryIndex].m_nameLength);
+
+				const uint32_t bucketSize = ++bucketSizes[entryHashes[entryIndex] & (BucketsCount - 1u)];
+				maxBucketSize = bucketSize > maxBucketSize ? bucketSize : maxBucketSize;
+			}
+
+			// Place the most populated buckets first, while the table is still sparse
+			for (uint32_t bucketSize = maxBucketSize; bucketSize != 0u; --bucketSize)
+			{
+				for (uint32_t bucketIndex = 0u; bucketIndex != BucketsCount; ++bucketIndex)
+				{
+					if (bucketSizes[bucketIndex] == bucketSize)
+					{
+						PlaceBucket(bucketIndex, entryHashes);
+					}
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool Parse(const char* name, uint64_t nameLength, EnumType& value) const
+		{
+			const uint32_t nameHash = Hash32(name, nameLength);
+			const uint32_t slot = m_slots[(nameHash * m_multipliers[nameHash & (BucketsCount - 1u)]) >> m_slotShift];
+
+			if (slot == 0u)
+			{
+				return false;
+			}
+
+			const EnumMapEntry<EnumType>& entry = m_entries[slot - 1u];
+
+			if (entry.m_nameLength != nameLength || memcmp(entry.m_name, name, nameLength) != 0)
+			{
+				return false;
+			}
+
+			value = entry.m_value;
+			return true;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool Parse(const std::string& name, EnumType& value) const
+		{
+			return Parse(name.data(), name.size(), value);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Reverse mapping, linear in the number of entries; returns nullptr for unknown values.
+		inline const char* ToString(EnumType value) const
+		{
+			for (const auto& entry : m_entries)
+			{
+				if (entry.m_value == value)
+				{
+					return entry.m_name;
+				}
+			}
+
+			return nullptr;
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		constexpr void PlaceBucket(uint32_t bucketIndex, const uint32_t (&entryHashes)[EntriesCount])
+		{
+			for (uint32_t attempt = 1u; attempt != MaxDisplacementAttempts; ++attempt)
+			{
+				const uint32_t multiplier = (attempt * 0x9e3779b9u) | 1u;
+				bool collided = false;
+
+				for (uint32_t entryIndex = 0u; entryIndex != EntriesCount && !collided; ++entryIndex)
+				{
+					if ((entryHashes[entryIndex] & (BucketsCount - 1u)) == bucketIndex)
+					{
+						const uint32_t slotIndex = (entryHashes[entryIndex] * multiplier) >> m_slotShift;
+
+						if (m_slots[slotIndex] == 0u)
+						{
+							m_slots[slotIndex] = entryIndex + 1u;
+						}
+						else
+						{
+							collided = true;
+						}
+					}
+				}
+
+				if (!collided)
+				{
+					m_multipliers[bucketIndex] = multiplier;
+					return;
+				}
+
+				// Roll back partially placed entries of this bucket
+				for (uint32_t& slot : m_slots)
+				{
+					if (slot != 0u && (entryHashes[slot - 1u] & (BucketsCount - 1u)) == bucketIndex)
+					{
+						slot = 0u;
+					}
+				}
+			}
+
+			// Not a constant expression, so a table that can't be placed fails to compile
+			throw std::logic_error("Enum map has duplicated names or a full 32 bit hash collision.");
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename EnumType, uint32_t EntriesCount>
+	constexpr EnumMap<EnumType, EntriesCount> MakeEnumMap(const EnumMapEntry<EnumType> (&entries)[EntriesCount])
+	{
+		return EnumMap<EnumType, EntriesCount>(entries);
+	}
+}
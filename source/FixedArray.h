@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Allocators.h"
+
 
 namespace aux
 {
@@ -12,14 +14,45 @@ namespace aux
 	};
 
 	//-------------------------------------------------------------------------------------------------
-	/// FixedArrayBase
+	/// FixedArrayAlignment - cache line for arithmetic types, so SIMD code may use aligned loads
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType>
+	class FixedArrayAlignment
+	{
+	public:
+		static constexpr uint32_t	value = std::is_arithmetic<DataType>::value && alignof(DataType) < 64u ? 64u : alignof(DataType);
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// IsTriviallyRelocatable - elements may be moved to another address with memcpy/realloc/mremap.
+	/// Trivially copyable types always are, specialize it for types which only keep pointers to the heap.
 	//-------------------------------------------------------------------------------------------------
 	template <typename DataType>
+	class IsTriviallyRelocatable : public std::is_trivially_copyable<DataType>
+	{
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, MemoryOwnage MemoryOwnageKind, uint32_t Alignment, typename AllocatorType, typename SizeType>
+	class FixedArray;
+
+	//-------------------------------------------------------------------------------------------------
+	/// FixedArrayBase
+	///
+	/// SizeType is uint32_t by default to keep arrays compact inside other structures, uint64_t lifts
+	/// the limit of 4G elements.
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, typename SizeType = uint32_t>
 	class FixedArrayBase
 	{
+		static_assert(std::is_integral<SizeType>::value && std::is_unsigned<SizeType>::value, "SizeType must be an unsigned integer.");
+
+		template <typename, MemoryOwnage, uint32_t, typename, typename>
+		friend class FixedArray;
+
 	protected:
 		DataType*					m_value;
-		uint32_t					m_size;
+		SizeType					m_size;
 
 	public:
 		//---------------------------------------------------------------------------------------------
@@ -28,7 +61,7 @@ namespace aux
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline uint32_t size() const
+		inline SizeType size() const
 		{
 			return m_size;
 		}
@@ -76,16 +109,148 @@ namespace aux
 			assert(index < static_cast<IndexType>(m_size));
 			return m_value[index];
 		}
+
+	protected:
+		//---------------------------------------------------------------------------------------------
+		inline static void CopyElements(DataType* destination, const DataType* source, SizeType elementsCount)
+		{
+			if (std::is_trivially_copyable<DataType>::value)
+			{
+				if (elementsCount != 0u)
+				{
+					memcpy(static_cast<void*>(destination), source, sizeof(DataType) * elementsCount);
+				}
+			}
+			else
+			{
+				for (SizeType elementIndex = 0u; elementIndex != elementsCount; ++elementIndex)
+				{
+					destination[elementIndex] = source[elementIndex];
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline static void MoveElements(DataType* destination, DataType* source, SizeType elementsCount)
+		{
+			if (std::is_trivially_copyable<DataType>::value)
+			{
+				if (elementsCount != 0u)
+				{
+					memcpy(static_cast<void*>(destination), source, sizeof(DataType) * elementsCount);
+				}
+			}
+			else
+			{
+				for (SizeType elementIndex = 0u; elementIndex != elementsCount; ++elementIndex)
+				{
+					destination[elementIndex] = std::move(source[elementIndex]);
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline static void ConstructElements(DataType* elements, SizeType elementsCount)
+		{
+			if (!std::is_trivially_default_constructible<DataType>::value)
+			{
+				for (SizeType elementIndex = 0u; elementIndex != elementsCount; ++elementIndex)
+				{
+					new (elements + elementIndex) DataType;
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline static void FillElements(DataType* elements, SizeType elementsCount, const DataType& fillValue)
+		{
+			for (SizeType elementIndex = 0u; elementIndex != elementsCount; ++elementIndex)
+			{
+				new (elements + elementIndex) DataType(fillValue);
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline static void CopyConstructElements(DataType* destination, const DataType* source, SizeType elementsCount)
+		{
+			if (std::is_trivially_copyable<DataType>::value)
+			{
+				if (elementsCount != 0u)
+				{
+					memcpy(static_cast<void*>(destination), source, sizeof(DataType) * elementsCount);
+				}
+			}
+			else
+			{
+				for (SizeType elementIndex = 0u; elementIndex != elementsCount; ++elementIndex)
+				{
+					new (destination + elementIndex) DataType(source[elementIndex]);
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Moves elements into unconstructed memory, the source elements are left destroyed.
+		inline static void RelocateElements(DataType* destination, DataType* source, SizeType elementsCount)
+		{
+			if (IsTriviallyRelocatable<DataType>::value)
+			{
+				if (elementsCount != 0u)
+				{
+					memcpy(static_cast<void*>(destination), static_cast<const void*>(source), sizeof(DataType) * elementsCount);
+				}
+			}
+			else
+			{
+				for (SizeType elementIndex = 0u; elementIndex != elementsCount; ++elementIndex)
+				{
+					new (destination + elementIndex) DataType(std::move(source[elementIndex]));
+					source[elementIndex].~DataType();
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline static void DestroyElements(DataType* elements, SizeType elementsCount)
+		{
+			if (!std::is_trivially_destructible<DataType>::value)
+			{
+				for (SizeType elementIndex = 0u; elementIndex != elementsCount; ++elementIndex)
+				{
+					elements[elementIndex].~DataType();
+				}
+			}
+		}
 	};
 
 	//-------------------------------------------------------------------------------------------------
-	template <typename DataType, MemoryOwnage MemoryOwnageKind = MemoryOwnage::OwnsMemory>
+	/// FixedArray
+	///
+	/// OwnsMemory - allocates and releases its own storage.
+	/// ExternalMemory - non-owning view over memory that belongs to somebody else (mmapped files, arenas).
+	/// AdaptMemory - owns its storage or borrows an external one, switches to owned storage on the first
+	/// operation that needs to reallocate.
+	///
+	/// Owned storage is aligned to Alignment bytes and comes from AllocatorType (HeapAllocator, or
+	/// HugePageAllocator for large buffers that suffer from TLB misses). Elements of trivially
+	/// constructible types are left uninitialized by Allocate() and Reallocate(), just like with new[],
+	/// use Resize() or the fill constructor when they need a value. Reallocate(), Resize() and Append()
+	/// resize trivially relocatable arrays with the allocator's Reallocate(), for HeapAllocator arrays
+	/// of a megabyte and more that is mremap without copying. Stateful allocators (ArenaAllocator)
+	/// travel with the storage on copy construction, moves and swaps.
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, MemoryOwnage MemoryOwnageKind = MemoryOwnage::OwnsMemory, uint32_t Alignment = FixedArrayAlignment<DataType>::value, typename AllocatorType = HeapAllocator, typename SizeType = uint32_t>
 	class FixedArray { };
 
 	//-------------------------------------------------------------------------------------------------
-	template <typename DataType>
-	class FixedArray<DataType, MemoryOwnage::OwnsMemory> : public FixedArrayBase<DataType>
+	template <typename DataType, uint32_t Alignment, typename AllocatorType, typename SizeType>
+	class FixedArray<DataType, MemoryOwnage::OwnsMemory, Alignment, AllocatorType, SizeType> : public FixedArrayBase<DataType, SizeType>, private AllocatorType
 	{
+		static_assert(Alignment >= alignof(DataType) && (Alignment & (Alignment - 1u)) == 0u, "Alignment must be a power of two not weaker than the natural one.");
+
+	private:
+		typedef FixedArray<DataType, MemoryOwnage::AdaptMemory, Alignment, AllocatorType, SizeType> AdaptingArray;
+
 	public:
 		//---------------------------------------------------------------------------------------------
 		inline FixedArray()
@@ -93,38 +258,42 @@ namespace aux
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline FixedArray(uint32_t size)
+		inline FixedArray(SizeType size, const AllocatorType& allocator = AllocatorType()) : AllocatorType(allocator)
 		{
 			this->m_size = size;
-			this->m_value = size ? new DataType[size] : nullptr;
+			this->m_value = AllocateElements(size);
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline FixedArray(const FixedArrayBase<DataType>& source)
+		inline FixedArray(SizeType size, const DataType& fillValue, const AllocatorType& allocator = AllocatorType()) : AllocatorType(allocator)
 		{
-			this->size = source.size;
-			this->m_value = source.size ? new DataType[source.size] : nullptr;
+			this->m_size = size;
+			this->m_value = AllocateStorage(size);
 
-			if (std::is_pod<DataType>::value)
-			{
-				memcpy_s(this->m_value, sizeof(DataType) * source.size, source.m_value, sizeof(DataType) * source.size);
-			}
-			else
-			{
-				for (uint32_t i = 0; i != source.size; ++i)
-				{
-					this->m_value[i] = source.m_value[i];
-				}
-			}
+			this->FillElements(this->m_value, size, fillValue);
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline FixedArray(const FixedArray& source) : FixedArray(static_cast<const FixedArrayBase<DataType>&>(source))
+		inline FixedArray(const DataType* source, SizeType sourceLength, const AllocatorType& allocator = AllocatorType()) : AllocatorType(allocator)
+		{
+			this->m_size = sourceLength;
+			this->m_value = AllocateStorage(sourceLength);
+
+			this->CopyConstructElements(this->m_value, source, sourceLength);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray(const FixedArrayBase<DataType, SizeType>& source, const AllocatorType& allocator = AllocatorType()) : FixedArray(source.data(), source.size(), allocator)
 		{
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline FixedArray(FixedArray&& source)
+		inline FixedArray(const FixedArray& source) : FixedArray(source.data(), source.size(), source.GetAllocator())
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray(FixedArray&& source) : AllocatorType(source.GetAllocator())
 		{
 			this->m_value = source.m_value;
 			this->m_size = source.m_size;
@@ -132,6 +301,13 @@ namespace aux
 			source.m_size = 0;
 		}
 
+		//---------------------------------------------------------------------------------------------
+		/// Takes over the storage of an adapting array, borrowed memory gets copied.
+		inline FixedArray(AdaptingArray&& source)
+		{
+			Swap(source);
+		}
+
 		//---------------------------------------------------------------------------------------------
 		inline ~FixedArray()
 		{
@@ -139,30 +315,56 @@ namespace aux
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline FixedArray& Allocate(uint32_t size)
+		/// Discards the content when the size changes.
+		inline FixedArray& Allocate(SizeType size)
 		{
 			if (this->m_size != size)
 			{
-				if (this->m_value)
-				{
-					delete[] this->m_value;
-				}
+				DeallocateElements(this->m_value, this->m_size);
+
 				this->m_size = size;
-				this->m_value = size ? new DataType[size] : nullptr;
+				this->m_value = AllocateElements(size);
 			}
 
 			return *this;
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline void Deallocate()
+		/// Keeps the leading min(size(), size) elements, new elements are default constructed.
+		inline FixedArray& Reallocate(SizeType size)
 		{
-			if (this->m_value)
+			const SizeType oldSize = ResizeStorage(size);
+
+			if (size > oldSize)
 			{
-				delete[] this->m_value;
-				this->m_value = nullptr;
+				this->ConstructElements(this->m_value + oldSize, size - oldSize);
+			}
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Keeps the leading min(size(), size) elements, new elements are copies of fillValue.
+		inline FixedArray& Resize(SizeType size, const DataType& fillValue = DataType())
+		{
+			// fillValue may live inside the storage which is about to move
+			const DataType value(fillValue);
+			const SizeType oldSize = ResizeStorage(size);
+
+			if (size > oldSize)
+			{
+				this->FillElements(this->m_value + oldSize, size - oldSize, value);
 			}
 
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void Deallocate()
+		{
+			DeallocateElements(this->m_value, this->m_size);
+
+			this->m_value = nullptr;
 			this->m_size = 0;
 		}
 
@@ -173,43 +375,135 @@ namespace aux
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline FixedArray& operator=(const FixedArrayBase<DataType>& source)
+		inline const AllocatorType& GetAllocator() const
 		{
-			if (this == &source)
-			{
-				return *this;
-			}
+			return *this;
+		}
 
-			if (this->m_size != source.m_size)
+		//---------------------------------------------------------------------------------------------
+		/// Copies content of any array kind, the storage is reused when sizes match.
+		inline FixedArray& Copy(const DataType* source, SizeType sourceLength)
+		{
+			if (this->m_size == sourceLength)
 			{
-				if (this->m_value)
+				if (this->m_value != source)
 				{
-					delete[] this->m_value;
+					this->CopyElements(this->m_value, source, sourceLength);
 				}
 
-				this->m_size = source.size;
-				this->m_value = source.size ? new DataType[source.size] : nullptr;
+				return *this;
 			}
 
-			if (std::is_pod<DataType>::value)
+			// Source may point into this array, so build the new storage before releasing the old one
+			DataType* newValue = AllocateStorage(sourceLength);
+
+			this->CopyConstructElements(newValue, source, sourceLength);
+			DeallocateElements(this->m_value, this->m_size);
+
+			this->m_value = newValue;
+			this->m_size = sourceLength;
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& Copy(const FixedArrayBase<DataType, SizeType>& source)
+		{
+			return Copy(source.data(), source.size());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename IteratorType>
+		inline FixedArray& Copy(IteratorType first, IteratorType last)
+		{
+			return CopyRange(first, last, std::integral_constant<bool, std::is_convertible<IteratorType, const DataType*>::value>());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& Append(const DataType* source, SizeType sourceLength)
+		{
+			if (sourceLength == 0u)
 			{
-				memcpy_s(this->m_value, sizeof(DataType) * source.size, source.m_value, sizeof(DataType) * source.size);
+				return *this;
 			}
-			else
+
+			const SizeType oldSize = this->m_size;
+
+			if (IsTriviallyRelocatable<DataType>::value)
 			{
-				for (uint32_t i = 0; i != source.size; ++i)
-				{
-					this->m_value[i] = source.m_value[i];
-				}
+				// Source may point into this array, the storage may move while it grows
+				const bool sourceInside = std::greater_equal<const DataType*>()(source, this->m_value) && std::less<const DataType*>()(source, this->m_value + oldSize);
+				const size_t sourceOffset = sourceInside ? source - this->m_value : 0u;
+
+				ResizeStorage(oldSize + sourceLength);
+				this->CopyConstructElements(this->m_value + oldSize, sourceInside ? this->m_value + sourceOffset : source, sourceLength);
+
+				return *this;
 			}
 
+			DataType* newValue = AllocateStorage(oldSize + sourceLength);
+
+			// Source may point into this array, so copy it before the old elements are moved out
+			this->CopyConstructElements(newValue + oldSize, source, sourceLength);
+			this->RelocateElements(newValue, this->m_value, oldSize);
+			DeallocateStorage(this->m_value, oldSize);
+
+			this->m_value = newValue;
+			this->m_size = oldSize + sourceLength;
+
 			return *this;
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline FixedArray<DataType>& operator= (const FixedArray<DataType>& source)
+		inline FixedArray& Append(const FixedArrayBase<DataType, SizeType>& source)
+		{
+			return Append(source.data(), source.size());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Generic iterators must not point into this array, pointers may.
+		template <typename IteratorType>
+		inline FixedArray& Append(IteratorType first, IteratorType last)
 		{
-			return *this = static_cast<const FixedArrayBase<DataType>&>(source);
+			return AppendRange(first, last, std::integral_constant<bool, std::is_convertible<IteratorType, const DataType*>::value>());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& Swap(FixedArray& another)
+		{
+			std::swap(this->m_value, another.m_value);
+			std::swap(this->m_size, another.m_size);
+			std::swap(static_cast<AllocatorType&>(*this), static_cast<AllocatorType&>(another));
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& Swap(AdaptingArray& another)
+		{
+			another.Swap(*this);
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& operator= (const FixedArrayBase<DataType, SizeType>& source)
+		{
+			return Copy(source);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& operator= (const FixedArray& source)
+		{
+			return Copy(source);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& operator= (AdaptingArray&& source)
+		{
+			Deallocate();
+
+			return Swap(source);
 		}
 
 		//---------------------------------------------------------------------------------------------
@@ -220,244 +514,527 @@ namespace aux
 				return *this;
 			}
 
-			if (this->m_value)
-			{
-				delete[] this->m_value;
-			}
+			DeallocateElements(this->m_value, this->m_size);
 
 			this->m_value = source.m_value;
 			this->m_size = source.m_size;
+			static_cast<AllocatorType&>(*this) = source.GetAllocator();
 			source.m_value = nullptr;
 			source.m_size = 0;
 
 			return *this;
 		}
-	};
-/*
-	//---------------------------------------------------------------------
-	template <typename T, typename TAllocator>
-	class FixedArray<T, EXT_MEM, TAllocator> : public FixedArrayBase<T>, public ISerializableValue
-	{
-	public:
-		//---------------------------------------------------------------------
-		/// Default constructor.
-		inline FixedArray() { }
 
-		//---------------------------------------------------------------------
-		/// Constructor for external memory version.
-		inline FixedArray(T* extMem, u32 extMemSize)
+	protected:
+		//---------------------------------------------------------------------------------------------
+		inline DataType* AllocateStorage(SizeType elementsCount)
 		{
-			this->size = extMemSize;
-			this->v = extMem;
+			return elementsCount ? static_cast<DataType*>(AllocatorType::Allocate(sizeof(DataType) * elementsCount, Alignment)) : nullptr;
 		}
 
-		//---------------------------------------------------------------------
-		/// Constructor for external memory version.
-		inline FixedArray(T* extMem, u32 extMemSize, const T& filler)
+		//---------------------------------------------------------------------------------------------
+		inline void DeallocateStorage(DataType* elements, SizeType elementsCount)
 		{
-			this->size = extMemSize;
-			this->v = extMem;
-			for (u32 i = 0; i < this->size; ++i)
-				this->v[i] = filler;
+			if (elements)
+			{
+				AllocatorType::Deallocate(elements, sizeof(DataType) * elementsCount);
+			}
 		}
 
-		//---------------------------------------------------------------------
-		/// Destructor.
-		inline ~FixedArray()
+		//---------------------------------------------------------------------------------------------
+		inline DataType* AllocateElements(SizeType elementsCount)
 		{
+			DataType* elements = AllocateStorage(elementsCount);
+
+			this->ConstructElements(elements, elementsCount);
+
+			return elements;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void DeallocateElements(DataType* elements, SizeType elementsCount)
+		{
+			if (elements)
+			{
+				this->DestroyElements(elements, elementsCount);
+				DeallocateStorage(elements, elementsCount);
+			}
 		}
 
-		//---------------------------------------------------------------------
-		/// Sets memory for non-owning version.
-		inline FixedArray& SetMemory(T* extMem, u32 extMemSize)
+		//---------------------------------------------------------------------------------------------
+		/// Changes the storage size keeping the leading elements, returns the old size.
+		/// Elements past the old size are left unconstructed.
+		inline SizeType ResizeStorage(SizeType size)
 		{
-			this->v = extMem;
-			this->size = extMemSize;
+			const SizeType oldSize = this->m_size;
+
+			if (size == oldSize)
+			{
+				return oldSize;
+			}
+
+			if (size < oldSize)
+			{
+				this->DestroyElements(this->m_value + size, oldSize - size);
+			}
+
+			if (size == 0u)
+			{
+				DeallocateStorage(this->m_value, oldSize);
+
+				this->m_value = nullptr;
+			}
+			else if (this->m_value == nullptr)
+			{
+				this->m_value = AllocateStorage(size);
+			}
+			else if (IsTriviallyRelocatable<DataType>::value)
+			{
+				this->m_value = static_cast<DataType*>(AllocatorType::Reallocate(this->m_value, sizeof(DataType) * oldSize, sizeof(DataType) * size, Alignment));
+			}
+			else
+			{
+				DataType* newValue = AllocateStorage(size);
+
+				this->RelocateElements(newValue, this->m_value, std::min(size, oldSize));
+				DeallocateStorage(this->m_value, oldSize);
+
+				this->m_value = newValue;
+			}
+
+			this->m_size = size;
+
+			return oldSize;
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		template <typename IteratorType>
+		inline FixedArray& CopyRange(IteratorType first, IteratorType last, std::true_type)
+		{
+			const DataType* source = first;
+
+			return Copy(source, static_cast<SizeType>(static_cast<const DataType*>(last) - source));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename IteratorType>
+		inline FixedArray& CopyRange(IteratorType first, IteratorType last, std::false_type)
+		{
+			const SizeType sourceLength = static_cast<SizeType>(std::distance(first, last));
+
+			if (this->m_size == sourceLength)
+			{
+				std::copy(first, last, this->m_value);
+
+				return *this;
+			}
+
+			DataType* newValue = AllocateStorage(sourceLength);
+
+			for (DataType* element = newValue; first != last; ++first, ++element)
+			{
+				new (element) DataType(*first);
+			}
+
+			DeallocateElements(this->m_value, this->m_size);
+
+			this->m_value = newValue;
+			this->m_size = sourceLength;
+
 			return *this;
 		}
 
-		//---------------------------------------------------------------------
-		/// Copies content of another array.
-		template <typename TOther, EMemoryOwnage TMemoryOwnageOther, typename TAllocatorOther>
-		inline FixedArray& Copy(const FixedArray<TOther, TMemoryOwnageOther, TAllocatorOther>& src)
+		//---------------------------------------------------------------------------------------------
+		template <typename IteratorType>
+		inline FixedArray& AppendRange(IteratorType first, IteratorType last, std::true_type)
 		{
-			return Copy(src.Data(), src.Size());
+			const DataType* source = first;
+
+			return Append(source, static_cast<SizeType>(static_cast<const DataType*>(last) - source));
 		}
 
-		//---------------------------------------------------------------------
-		/// Copies content of another array.
-		template <typename TOther>
-		inline FixedArray& Copy(const TOther* src, u32 srcNumElements)
+		//---------------------------------------------------------------------------------------------
+		template <typename IteratorType>
+		inline FixedArray& AppendRange(IteratorType first, IteratorType last, std::false_type)
 		{
-			u32 numToCopy = Min(srcNumElements, this->size);
-			if (std::is_pod<TOther>::value && std::is_same<T, TOther>::value)
-				memcpy(this->v, src, sizeof(T) * numToCopy);
-			else
+			const SizeType oldSize = ResizeStorage(this->m_size + static_cast<SizeType>(std::distance(first, last)));
+
+			for (DataType* element = this->m_value + oldSize; first != last; ++first, ++element)
 			{
-				for (u32 i = 0; i < numToCopy; ++i)
-					this->v[i] = T(src[i]);
+				new (element) DataType(*first);
 			}
 
 			return *this;
 		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, uint32_t Alignment, typename AllocatorType, typename SizeType>
+	class FixedArray<DataType, MemoryOwnage::ExternalMemory, Alignment, AllocatorType, SizeType> : public FixedArrayBase<DataType, SizeType>
+	{
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray()
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray(DataType* externalMemory, SizeType externalMemorySize)
+		{
+			this->m_value = externalMemory;
+			this->m_size = externalMemorySize;
+		}
 
-		//---------------------------------------------------------------------
-		/// Assignment operator copies content of another array.
-		template <typename TOther, EMemoryOwnage TMemoryOwnageOther, typename TAllocatorOther>
-		inline FixedArray& operator =(const FixedArray<TOther, TMemoryOwnageOther, TAllocatorOther>& src)
+		//---------------------------------------------------------------------------------------------
+		/// View over the storage of any other array.
+		inline FixedArray(FixedArrayBase<DataType, SizeType>& source) : FixedArray(source.data(), source.size())
 		{
-			return Copy(src);
 		}
 
-		//---------------------------------------------------------------------
-		/// Copies pointer from another array.
-		inline FixedArray& CopyPointer(const FixedArray& op)
+		//---------------------------------------------------------------------------------------------
+		/// Copying a view makes another view of the same memory.
+		inline FixedArray(const FixedArray& source) : FixedArray(source.m_value, source.m_size)
 		{
-			this->v = op.v;
-			this->size = op.size;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& SetMemory(DataType* externalMemory, SizeType externalMemorySize)
+		{
+			this->m_value = externalMemory;
+			this->m_size = externalMemorySize;
+
 			return *this;
 		}
 
-		//---------------------------------------------------------------------
-		/// Serialization.
-		inline bool SerializeValue(ISerialize* ser, Id32 self, ESerializationFlags flags)
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& CopyPointer(const FixedArray& source)
+		{
+			return SetMemory(source.m_value, source.m_size);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Copies content into the external memory, never more than the view size.
+		inline FixedArray& Copy(const DataType* source, SizeType sourceLength)
 		{
-			if (ser->IsReading())
+			if (this->m_value != source)
 			{
-				assert(false); // do not use external allocated version of FixedArray for reading into
-				return false;
+				this->CopyElements(this->m_value, source, std::min(sourceLength, this->m_size));
 			}
 
-			u32 size = this->Size();
-			if (!ser->BeginArray(self, size, flags))
-				return false;
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& Copy(const FixedArrayBase<DataType, SizeType>& source)
+		{
+			return Copy(source.data(), source.size());
+		}
 
-			bool result = true;
-			for (u32 i = 0; i < this->size; ++i)
-				result &= ser->Value(i, this->At(i), SERIALIZE_MANDATORY);
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& Swap(FixedArray& another)
+		{
+			std::swap(this->m_value, another.m_value);
+			std::swap(this->m_size, another.m_size);
 
-			ser->EndArray();
-			return result;
+			return *this;
 		}
 
-		//---------------------------------------------------------------------
-		/// Checks if fixed array is initialized.
-		inline operator bool() const
+		//---------------------------------------------------------------------------------------------
+		/// Assignment copies content, use CopyPointer() or SetMemory() to rebind the view.
+		inline FixedArray& operator= (const FixedArrayBase<DataType, SizeType>& source)
 		{
-			return this->v != nullptr;
+			return Copy(source);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& operator= (const FixedArray& source)
+		{
+			return Copy(source);
 		}
 	};
 
-	//---------------------------------------------------------------------
-	template <typename T, typename TAllocator>
-	class FixedArray<T, ADAPT_MEM, TAllocator> : public FixedArray<T, OWNS_MEM, TAllocator>
+	//-------------------------------------------------------------------------------------------------
+	/// The owning array is a member rather than a base, so an adapting array never binds to a
+	/// reference of the owning kind that would release borrowed memory. The base pointer and size
+	/// mirror the owning array while owning and describe the external memory while borrowing.
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, uint32_t Alignment, typename AllocatorType, typename SizeType>
+	class FixedArray<DataType, MemoryOwnage::AdaptMemory, Alignment, AllocatorType, SizeType> : public FixedArrayBase<DataType, SizeType>
 	{
-		using Base = FixedArray<T, OWNS_MEM, TAllocator>;
-
-	protected:
-		bool ownsMem = false;
+	private:
+		typedef FixedArray<DataType, MemoryOwnage::OwnsMemory, Alignment, AllocatorType, SizeType> OwningArray;
 
-	protected:
-		//---------------------------------------------------------------------
-		/// Deallocates own memory.
-		inline void InternalDeallocateOwn() { if (ownsMem) { Deallocate(); } }
-		inline void InternalSetToOwn() { if (!ownsMem) { this->v = nullptr; this->size = 0; ownsMem = true; } }
+	private:
+		OwningArray					m_ownedArray;					///< empty while borrowing
+		bool						m_ownsMemory;
 
 	public:
-		//---------------------------------------------------------------------
-		/// Adapted overloads for owning memory version.
-		//---------------------------------------------------------------------
-		inline FixedArray() { }
-		//---------------------------------------------------------------------
-		inline FixedArray(u32 _size) : Base(_size) { ownsMem = true; }
-		//---------------------------------------------------------------------
-		inline FixedArray(u32 _size, const T& filler) : Base(_size, filler) { ownsMem = true; }
-		//---------------------------------------------------------------------
-		inline FixedArray(const FixedArray& op) : Base(op) { ownsMem = true; }
-		//---------------------------------------------------------------------
-		inline FixedArray& operator=(const FixedArray& op) { Base::operator =(op); ownsMem = true; return *this; }
-		//---------------------------------------------------------------------
-		template <typename F>
-		inline FixedArray(const eastl::vector<F>& op) : Base(op) { ownsMem = true; }
-		//---------------------------------------------------------------------
-		template <typename F>
-		inline FixedArray& operator=(const eastl::vector<F>& op) { Base::operator =(op); ownsMem = true; return *this; }
-		//---------------------------------------------------------------------
-		template <typename F>
-		inline FixedArray(const F* begin, const F* end) : Base(begin, end) { ownsMem = true; }
-		//---------------------------------------------------------------------
-		inline FixedArray(FixedArray&& op) : Base(std::move(op)) { ownsMem = op.ownsMem; }
-		//---------------------------------------------------------------------
-		inline FixedArray& operator=(FixedArray&& op) { Base::operator =(std::move(op)); ownsMem = op.ownsMem; return *this; }
-		//---------------------------------------------------------------------
-		template <typename F>
-		inline FixedArray(std::initializer_list<F> list) : Base(list.begin(), list.end()) { ownsMem = true; }
-
-		//---------------------------------------------------------------------
-		/// Constructor for external memory version.
-		inline FixedArray(T* extMem, u32 extMemSize)
-		{
-			this->size = extMemSize;
-			this->v = extMem;
-			ownsMem = false;
-		}
-
-		//---------------------------------------------------------------------
-		/// Constructor for external memory version.
-		inline FixedArray(T* extMem, u32 extMemSize, const T& filler)
-		{
-			this->size = extMemSize;
-			this->v = extMem;
-			Fill(filler);
-			ownsMem = false;
-		}
-
-		//---------------------------------------------------------------------
-		/// Destructor.
-		inline ~FixedArray() { InternalDeallocateOwn(); }
-
-		//---------------------------------------------------------------------
-		/// Adapted overloads for owning memory version.
-		//---------------------------------------------------------------------
-		inline FixedArray& Allocate(u32 _size) { InternalSetToOwn(); Base::Allocate(_size); return *this; }
-		//---------------------------------------------------------------------
-		inline FixedArray& Allocate(u32 _size, const T& filler) { InternalSetToOwn(); Base::Allocate(_size, filler); return *this; }
-		//---------------------------------------------------------------------
-		inline FixedArray& Reallocate(u32 _size) { InternalSetToOwn(); Base::Reallocate(_size); return *this; }
-		//---------------------------------------------------------------------
-		inline FixedArray& Reallocate(u32 _size, const T& filler) { InternalSetToOwn(); Base::Reallocate(_size, filler); return *this; }
-		//---------------------------------------------------------------------
-		inline void Deallocate() { InternalSetToOwn(); Base::Deallocate(); }
-		//---------------------------------------------------------------------
-		inline bool IsAllocated() const { if (ownsMem) return this->v != nullptr; return false; }
-		//---------------------------------------------------------------------
-		inline FixedArray& Swap(FixedArray& op) { std::swap(ownsMem, op.ownsMem); Base::Swap(op); return *this; }
-		//---------------------------------------------------------------------
-		template <typename F>
-		inline FixedArray& Copy(const FixedArrayBase<F>& source) { InternalSetToOwn(); Base::Copy(source); return *this; }
-		//---------------------------------------------------------------------
-		template <typename F>
-		inline FixedArray& Copy(const FixedArrayBase<F>& source, u32 sourceStart, u32 sourceLength) { InternalSetToOwn(); Base::Copy(source, sourceStart, sourceLength); return *this; }
-		//---------------------------------------------------------------------
-		inline FixedArray& Copy(const T* src, u32 srcNumElements) { InternalSetToOwn(); Base::Copy(src, srcNumElements); }
-		//---------------------------------------------------------------------
-		template <typename F>
-		inline FixedArray& Append(const FixedArrayBase<F>& source) { InternalSetToOwn(); Base::Append(source); return *this; }
-		//---------------------------------------------------------------------
-		template <typename F>
-		inline FixedArray& Append(const FixedArrayBase<F>& source, u32 sourceStart, u32 sourceLength, u32 thisPosition = -1) { InternalSetToOwn(); Base::Append(source, sourceStart, sourceLength, thisPosition); return *this; }
-
-		//---------------------------------------------------------------------
-		/// Sets memory for non-owning version.
-		inline FixedArray& SetMemory(T* extMem, u32 extMemSize)
-		{
-			InternalDeallocateOwn();
-			this->v = extMem;
-			this->size = extMemSize;
-			ownsMem = false;
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray() : m_ownsMemory(true)
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray(SizeType size) : m_ownedArray(size), m_ownsMemory(true)
+		{
+			Synchronize();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray(SizeType size, const DataType& fillValue) : m_ownedArray(size, fillValue), m_ownsMemory(true)
+		{
+			Synchronize();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Borrows external memory.
+		inline FixedArray(DataType* externalMemory, SizeType externalMemorySize) : m_ownsMemory(false)
+		{
+			this->m_value = externalMemory;
+			this->m_size = externalMemorySize;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Copying always produces an owning array.
+		inline FixedArray(const FixedArrayBase<DataType, SizeType>& source) : m_ownedArray(source), m_ownsMemory(true)
+		{
+			Synchronize();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray(const FixedArray& source) : m_ownedArray(source.data(), source.size(), source.GetAllocator()), m_ownsMemory(true)
+		{
+			Synchronize();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray(FixedArray&& source) : m_ownedArray(std::move(source.m_ownedArray)), m_ownsMemory(source.m_ownsMemory)
+		{
+			this->m_value = source.m_value;
+			this->m_size = source.m_size;
+			source.m_value = nullptr;
+			source.m_size = 0;
+			source.m_ownsMemory = true;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Takes over the storage of an owning array.
+		inline FixedArray(OwningArray&& source) : m_ownedArray(std::move(source)), m_ownsMemory(true)
+		{
+			Synchronize();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool OwnsMemory() const
+		{
+			return m_ownsMemory;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& SetMemory(DataType* externalMemory, SizeType externalMemorySize)
+		{
+			Deallocate();
+
+			this->m_value = externalMemory;
+			this->m_size = externalMemorySize;
+			m_ownsMemory = false;
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& Allocate(SizeType size)
+		{
+			ReleaseBorrowed();
+			m_ownedArray.Allocate(size);
+			Synchronize();
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& Reallocate(SizeType size)
+		{
+			OwnBorrowed(size);
+			m_ownedArray.Reallocate(size);
+			Synchronize();
 
 			return *this;
 		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& Resize(SizeType size, const DataType& fillValue = DataType())
+		{
+			const DataType value(fillValue);
+
+			OwnBorrowed(size);
+			m_ownedArray.Resize(size, value);
+			Synchronize();
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void Deallocate()
+		{
+			ReleaseBorrowed();
+			m_ownedArray.Deallocate();
+			Synchronize();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool IsAllocated() const
+		{
+			return m_ownsMemory && this->m_value != nullptr;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline const AllocatorType& GetAllocator() const
+		{
+			return m_ownedArray.GetAllocator();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// The source may live inside borrowed memory, which stays untouched while the owned array,
+		/// empty while borrowing, gets the copy.
+		inline FixedArray& Copy(const DataType* source, SizeType sourceLength)
+		{
+			m_ownedArray.Copy(source, sourceLength);
+			m_ownsMemory = true;
+			Synchronize();
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& Copy(const FixedArrayBase<DataType, SizeType>& source)
+		{
+			return Copy(source.data(), source.size());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename IteratorType>
+		inline FixedArray& Copy(IteratorType first, IteratorType last)
+		{
+			m_ownedArray.Copy(first, last);
+			m_ownsMemory = true;
+			Synchronize();
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Appending to borrowed memory copies it into owned storage first, the source may point there.
+		inline FixedArray& Append(const DataType* source, SizeType sourceLength)
+		{
+			OwnBorrowed(this->m_size);
+			m_ownedArray.Append(source, sourceLength);
+			Synchronize();
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& Append(const FixedArrayBase<DataType, SizeType>& source)
+		{
+			return Append(source.data(), source.size());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename IteratorType>
+		inline FixedArray& Append(IteratorType first, IteratorType last)
+		{
+			OwnBorrowed(this->m_size);
+			m_ownedArray.Append(first, last);
+			Synchronize();
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& Swap(FixedArray& another)
+		{
+			m_ownedArray.Swap(another.m_ownedArray);
+			std::swap(this->m_value, another.m_value);
+			std::swap(this->m_size, another.m_size);
+			std::swap(m_ownsMemory, another.m_ownsMemory);
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Exchanges storage with an owning array, borrowed memory gets copied into owned storage first.
+		inline FixedArray& Swap(OwningArray& another)
+		{
+			OwnBorrowed(this->m_size);
+			m_ownedArray.Swap(another);
+			Synchronize();
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& operator= (const FixedArrayBase<DataType, SizeType>& source)
+		{
+			return Copy(source);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& operator= (const FixedArray& source)
+		{
+			return Copy(source);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline FixedArray& operator= (FixedArray&& source)
+		{
+			if (this == &source)
+			{
+				return *this;
+			}
+
+			Deallocate();
+
+			return Swap(source);
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		inline void Synchronize()
+		{
+			this->m_value = m_ownedArray.data();
+			this->m_size = m_ownedArray.size();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Replaces borrowed memory with an owned copy of its leading elements, at most keptLength of them.
+		inline void OwnBorrowed(SizeType keptLength)
+		{
+			if (!m_ownsMemory)
+			{
+				m_ownedArray.Copy(this->m_value, std::min(keptLength, this->m_size));
+				m_ownsMemory = true;
+				Synchronize();
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Forgets borrowed memory without releasing it, the array becomes an empty owning one.
+		inline void ReleaseBorrowed()
+		{
+			if (!m_ownsMemory)
+			{
+				this->m_value = nullptr;
+				this->m_size = 0u;
+				m_ownsMemory = true;
+			}
+		}
 	};
-*/
+
+	//-------------------------------------------------------------------------------------------------
+	/// LargeFixedArray - FixedArray with 64 bit element count
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, MemoryOwnage MemoryOwnageKind = MemoryOwnage::OwnsMemory>
+	using LargeFixedArray = FixedArray<DataType, MemoryOwnageKind, FixedArrayAlignment<DataType>::value, HeapAllocator, uint64_t>;
 }
@@ -18,6 +18,11 @@ namespace aux
 		{
 		}
 
+		//---------------------------------------------------------------------------------------------
+		inline explicit Hash(HashType startValue) : m_value(startValue)
+		{
+		}
+
 		//---------------------------------------------------------------------------------------------
 		inline HashType GetInternalValue() const
 		{
@@ -53,21 +58,54 @@ namespace aux
 			return *this;
 		}
 
+		//---------------------------------------------------------------------------------------------
+		/// Compile-time version of Calculate(), produces exactly the same values as the runtime one.
+		static constexpr HashType StaticCalculate(const char* buffer, uint64_t bufferLength, HashType startValue = 1u);
+
+		//---------------------------------------------------------------------------------------------
+		/// Full 128 bit output of x64 Murmur3, low half is the value Calculate() returns (64 bit hash only).
+		inline static void Calculate128(const void* buffer, uint64_t bufferLength, HashType startValue, uint64_t& lowHash, uint64_t& highHash);
+
+		//---------------------------------------------------------------------------------------------
+		/// Murmur3 finalization mix, a cheap bijective scrambler for integer values.
+		static constexpr uint32_t Mix32(uint32_t value)
+		{
+			return fmix32(value);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static constexpr uint64_t Mix64(uint64_t value)
+		{
+			return fmix64(value);
+		}
+
 	private:
 		//---------------------------------------------------------------------------------------------
-		inline static uint32_t rotl32(uint32_t x, int8_t r)
+		static constexpr uint32_t rotl32(uint32_t x, int8_t r)
 		{
 			return (x << r) | (x >> (32 - r));
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline static uint64_t rotl64(uint64_t x, int8_t r)
+		static constexpr uint64_t rotl64(uint64_t x, int8_t r)
 		{
 			return (x << r) | (x >> (64 - r));
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline static uint32_t fmix32(uint32_t h)
+		static constexpr uint32_t block32(const char* buffer)
+		{
+			return uint32_t(uint8_t(buffer[0])) | (uint32_t(uint8_t(buffer[1])) << 8) | (uint32_t(uint8_t(buffer[2])) << 16) | (uint32_t(uint8_t(buffer[3])) << 24);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static constexpr uint64_t block64(const char* buffer)
+		{
+			return uint64_t(block32(buffer)) | (uint64_t(block32(buffer + 4)) << 32);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static constexpr uint32_t fmix32(uint32_t h)
 		{
 			h ^= h >> 16;
 			h *= 0x85ebca6b;
@@ -79,7 +117,7 @@ namespace aux
 		}
 
 		//---------------------------------------------------------------------------------------------
-		inline static uint64_t fmix64(uint64_t k)
+		static constexpr uint64_t fmix64(uint64_t k)
 		{
 			k ^= k >> 33;
 			k *= 0xff51afd7ed558ccd;
@@ -128,8 +166,8 @@ namespace aux
 
 		switch (bufLen & 3)
 		{
-		case 3: k1 ^= tail[2] << 16;
-		case 2: k1 ^= tail[1] << 8;
+		case 3: k1 ^= tail[2] << 16; // fall through
+		case 2: k1 ^= tail[1] << 8; // fall through
 		case 1: k1 ^= tail[0];
 				k1 *= c1; k1 = rotl32(k1, 15); k1 *= c2; h1 ^= k1;
 		};
@@ -144,7 +182,7 @@ namespace aux
 
 	//-------------------------------------------------------------------------------------------------
 	template <>
-	inline uint64_t Hash<uint64_t>::Calculate(const void* buf, uint64_t bufLen, uint64_t startValue) const
+	inline void Hash<uint64_t>::Calculate128(const void* buf, uint64_t bufLen, uint64_t startValue, uint64_t& lowHash, uint64_t& highHash)
 	{
 		const uint8_t* data = (const uint8_t*)buf;
 		const uint64_t nblocks = bufLen / 16;
@@ -176,22 +214,22 @@ namespace aux
 
 		switch (bufLen & 15)
 		{
-		case 15: k2 ^= uint64_t(tail[14]) << 48;
-		case 14: k2 ^= uint64_t(tail[13]) << 40;
-		case 13: k2 ^= uint64_t(tail[12]) << 32;
-		case 12: k2 ^= uint64_t(tail[11]) << 24;
-		case 11: k2 ^= uint64_t(tail[10]) << 16;
-		case 10: k2 ^= uint64_t(tail[ 9]) << 8;
+		case 15: k2 ^= uint64_t(tail[14]) << 48; // fall through
+		case 14: k2 ^= uint64_t(tail[13]) << 40; // fall through
+		case 13: k2 ^= uint64_t(tail[12]) << 32; // fall through
+		case 12: k2 ^= uint64_t(tail[11]) << 24; // fall through
+		case 11: k2 ^= uint64_t(tail[10]) << 16; // fall through
+		case 10: k2 ^= uint64_t(tail[ 9]) << 8; // fall through
 		case  9: k2 ^= uint64_t(tail[ 8]) << 0;
-				 k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
-
-		case 8: k1 ^= uint64_t(tail[7]) << 56;
-		case 7: k1 ^= uint64_t(tail[6]) << 48;
-		case 6: k1 ^= uint64_t(tail[5]) << 40;
-		case 5: k1 ^= uint64_t(tail[4]) << 32;
-		case 4: k1 ^= uint64_t(tail[3]) << 24;
-		case 3: k1 ^= uint64_t(tail[2]) << 16;
-		case 2: k1 ^= uint64_t(tail[1]) << 8;
+				 k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2; // fall through
+
+		case 8: k1 ^= uint64_t(tail[7]) << 56; // fall through
+		case 7: k1 ^= uint64_t(tail[6]) << 48; // fall through
+		case 6: k1 ^= uint64_t(tail[5]) << 40; // fall through
+		case 5: k1 ^= uint64_t(tail[4]) << 32; // fall through
+		case 4: k1 ^= uint64_t(tail[3]) << 24; // fall through
+		case 3: k1 ^= uint64_t(tail[2]) << 16; // fall through
+		case 2: k1 ^= uint64_t(tail[1]) << 8; // fall through
 		case 1: k1 ^= uint64_t(tail[0]) << 0;
 				k1 *= c1; k1 = rotl64(k1,31); k1 *= c2; h1 ^= k1;
 		};
@@ -208,9 +246,130 @@ namespace aux
 		h1 += h2;
 		h2 += h1;
 
+		lowHash = h1;
+		highHash = h2;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <>
+	inline uint64_t Hash<uint64_t>::Calculate(const void* buf, uint64_t bufLen, uint64_t startValue) const
+	{
+		uint64_t h1, h2;
+		Calculate128(buf, bufLen, startValue, h1, h2);
+
 		return h1; // h2 contains bunch of equally mixed bits - can be used to output 128 bit value
 	}
 
+	//-------------------------------------------------------------------------------------------------
+	template <>
+	constexpr uint32_t Hash<uint32_t>::StaticCalculate(const char* buf, uint64_t bufLen, uint32_t startValue)
+	{
+		const uint64_t nblocks = bufLen / 4;
+
+		uint32_t h1 = startValue;
+
+		const uint32_t c1 = 0xcc9e2d51;
+		const uint32_t c2 = 0x1b873593;
+
+		// body
+		for (uint64_t i = 0; i < nblocks; ++i)
+		{
+			uint32_t k1 = block32(buf + i * 4);
+
+			k1 *= c1;
+			k1 = rotl32(k1, 15);
+			k1 *= c2;
+
+			h1 ^= k1;
+			h1 = rotl32(h1, 13);
+			h1 = h1 * 5 + 0xe6546b64;
+		}
+
+		// tail
+		const char* tail = buf + nblocks * 4;
+
+		uint32_t k1 = 0;
+
+		switch (bufLen & 3)
+		{
+		case 3: k1 ^= uint32_t(uint8_t(tail[2])) << 16; // fall through
+		case 2: k1 ^= uint32_t(uint8_t(tail[1])) << 8; // fall through
+		case 1: k1 ^= uint32_t(uint8_t(tail[0]));
+				k1 *= c1; k1 = rotl32(k1, 15); k1 *= c2; h1 ^= k1;
+		};
+
+		// finalization
+		h1 ^= (uint32_t)bufLen;
+
+		return fmix32(h1);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <>
+	constexpr uint64_t Hash<uint64_t>::StaticCalculate(const char* buf, uint64_t bufLen, uint64_t startValue)
+	{
+		const uint64_t nblocks = bufLen / 16;
+
+		uint64_t h1 = startValue >> 32;
+		uint64_t h2 = startValue & 0xFFFFFFFF;
+
+		const uint64_t c1 = 0x87c37b91114253d5;
+		const uint64_t c2 = 0x4cf5ad432745937f;
+
+		// body
+		for (uint64_t i = 0; i < nblocks; ++i)
+		{
+			uint64_t k1 = block64(buf + i * 16);
+			uint64_t k2 = block64(buf + i * 16 + 8);
+
+			k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+			h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+			k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+			h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+		}
+
+		// tail
+		const char* tail = buf + nblocks * 16;
+
+		uint64_t k1 = 0;
+		uint64_t k2 = 0;
+
+		switch (bufLen & 15)
+		{
+		case 15: k2 ^= uint64_t(uint8_t(tail[14])) << 48; // fall through
+		case 14: k2 ^= uint64_t(uint8_t(tail[13])) << 40; // fall through
+		case 13: k2 ^= uint64_t(uint8_t(tail[12])) << 32; // fall through
+		case 12: k2 ^= uint64_t(uint8_t(tail[11])) << 24; // fall through
+		case 11: k2 ^= uint64_t(uint8_t(tail[10])) << 16; // fall through
+		case 10: k2 ^= uint64_t(uint8_t(tail[ 9])) << 8; // fall through
+		case  9: k2 ^= uint64_t(uint8_t(tail[ 8])) << 0;
+				 k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2; // fall through
+
+		case 8: k1 ^= uint64_t(uint8_t(tail[7])) << 56; // fall through
+		case 7: k1 ^= uint64_t(uint8_t(tail[6])) << 48; // fall through
+		case 6: k1 ^= uint64_t(uint8_t(tail[5])) << 40; // fall through
+		case 5: k1 ^= uint64_t(uint8_t(tail[4])) << 32; // fall through
+		case 4: k1 ^= uint64_t(uint8_t(tail[3])) << 24; // fall through
+		case 3: k1 ^= uint64_t(uint8_t(tail[2])) << 16; // fall through
+		case 2: k1 ^= uint64_t(uint8_t(tail[1])) << 8; // fall through
+		case 1: k1 ^= uint64_t(uint8_t(tail[0])) << 0;
+				k1 *= c1; k1 = rotl64(k1,31); k1 *= c2; h1 ^= k1;
+		};
+
+		// finalization
+		h1 ^= bufLen; h2 ^= bufLen;
+
+		h1 += h2;
+		h2 += h1;
+
+		h1 = fmix64(h1);
+		h2 = fmix64(h2);
+
+		h1 += h2;
+
+		return h1;
+	}
+
 	//-------------------------------------------------------------------------------------------------
 	inline uint32_t Hash32(const void* buffer, uint64_t bufferLength)
 	{
@@ -226,4 +385,24 @@ namespace aux
 
 		return hasher.Add(buffer, bufferLength).GetInternalValue();
 	}
+
+	//-------------------------------------------------------------------------------------------------
+	inline void Hash128(const void* buffer, uint64_t bufferLength, uint64_t& lowHash, uint64_t& highHash)
+	{
+		Hash<uint64_t>::Calculate128(buffer, bufferLength, 1u, lowHash, highHash);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <size_t LiteralSize>
+	constexpr uint32_t StaticHash32(const char (&literal)[LiteralSize])
+	{
+		return Hash<uint32_t>::StaticCalculate(literal, LiteralSize - 1u);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <size_t LiteralSize>
+	constexpr uint64_t StaticHash64(const char (&literal)[LiteralSize])
+	{
+		return Hash<uint64_t>::StaticCalculate(literal, LiteralSize - 1u);
+	}
 }
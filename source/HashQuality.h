@@ -0,0 +1,356 @@
+#pragma once
+
+#include "Hash.h"
+#include "TreeHash.h"
+#include "Clock.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// Hasher adapters
+	///
+	/// Every adapter exposes HashBits, SeedBits and operator() (buffer, bufferLength, seed).
+	//-------------------------------------------------------------------------------------------------
+	class Murmur32Hasher
+	{
+	public:
+		static constexpr uint32_t	HashBits = 32u;
+		static constexpr uint32_t	SeedBits = 32u;
+
+	public:
+		forceinline uint64_t operator() (const void* buffer, uint64_t bufferLength, uint64_t seed) const
+		{
+			return Hash<uint32_t>(static_cast<uint32_t>(seed)).Add(buffer, bufferLength).GetInternalValue();
+		}
+	};
+
+	class Murmur64Hasher
+	{
+	public:
+		static constexpr uint32_t	HashBits = 64u;
+		static constexpr uint32_t	SeedBits = 64u;
+
+	public:
+		forceinline uint64_t operator() (const void* buffer, uint64_t bufferLength, uint64_t seed) const
+		{
+			return Hash<uint64_t>(seed).Add(buffer, bufferLength).GetInternalValue();
+		}
+	};
+
+	/// High half of the 128 bit Murmur3 output, the part used as probe step by BloomFilter and CountMinSketch.
+	class Murmur128HighHasher
+	{
+	public:
+		static constexpr uint32_t	HashBits = 64u;
+		static constexpr uint32_t	SeedBits = 64u;
+
+	public:
+		forceinline uint64_t operator() (const void* buffer, uint64_t bufferLength, uint64_t seed) const
+		{
+			uint64_t lowHash, highHash;
+			Hash<uint64_t>::Calculate128(buffer, bufferLength, seed, lowHash, highHash);
+
+			return highHash;
+		}
+	};
+
+	/// Tree hash has no seed, so its seed sensitivity is meaningless and reported as the worst one.
+	class TreeHash64Hasher
+	{
+	public:
+		static constexpr uint32_t	HashBits = 64u;
+		static constexpr uint32_t	SeedBits = 0u;
+
+	public:
+		forceinline uint64_t operator() (const void* buffer, uint64_t bufferLength, uint64_t seed) const
+		{
+			return TreeHash64(buffer, bufferLength);
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// HashBenchmark
+	///
+	/// Throughput over key lengths from 1 byte to 1 MB on aligned and deliberately misaligned input,
+	/// plus a subset of SMHasher quality checks. Biases are normalized to [0, 1]: zero is an ideal hash,
+	/// one is a bit that always (or never) flips. Being worst cases over thousands of cells they carry
+	/// sampling noise of about 4 / sqrt(samples), so compare hashers at equal samples counts.
+	//-------------------------------------------------------------------------------------------------
+	class HashBenchmark
+	{
+	public:
+		class ThroughputResult
+		{
+		public:
+			uint64_t				m_keyLength;
+			bool					m_aligned;
+			double					m_nanosecondsPerHash;
+			double					m_megabytesPerSecond;
+		};
+
+		class QualityResult
+		{
+		public:
+			double					m_avalancheBias;				///< worst deviation of an output bit flip probability from 1/2
+			double					m_bitIndependenceBias;			///< worst correlation between flips of two output bits
+			double					m_seedSensitivityBias;			///< avalanche bias of seed bits
+		};
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		template <typename Hasher>
+		static ThroughputResult MeasureThroughput(const Hasher& hasher, uint64_t keyLength, bool aligned, uint64_t bytesBudget = 64u << 20)
+		{
+			constexpr uint64_t CacheLineLength = 64u;
+
+			std::vector<byte> buffer(keyLength + CacheLineLength * 2u);
+			std::mt19937_64 random(keyLength);
+
+			for (auto& bufferByte : buffer)
+			{
+				bufferByte = static_cast<byte>(random());
+			}
+
+			// Cache line aligned start, or one byte past it to break every 4 and 8 byte block read
+			const uintptr_t bufferAddress = reinterpret_cast<uintptr_t>(buffer.data());
+			const byte* keyData = reinterpret_cast<const byte*>((bufferAddress + CacheLineLength - 1u) & ~(CacheLineLength - 1u)) + (aligned ? 0u : 1u);
+
+			const uint64_t iterationsCount = std::max<uint64_t>(bytesBudget / std::max<uint64_t>(keyLength, 1u), 16u);
+			uint64_t hashesSum = 0u;
+
+			Clock clock;
+
+			for (uint64_t iteration = 0u; iteration != iterationsCount; ++iteration)
+			{
+				hashesSum += hasher(keyData, keyLength, iteration);
+			}
+
+			const double elapsedNanoseconds = static_cast<double>(std::max<int64_t>(clock.DeltaMicroseconds(), 1)) * 1000.0;
+
+			// Keep the loop observable for the optimizer
+			volatile uint64_t hashesSink = hashesSum;
+			(void)hashesSink;
+
+			ThroughputResult result;
+			result.m_keyLength = keyLength;
+			result.m_aligned = aligned;
+			result.m_nanosecondsPerHash = elapsedNanoseconds / static_cast<double>(iterationsCount);
+			result.m_megabytesPerSecond = static_cast<double>(keyLength * iterationsCount) / elapsedNanoseconds * (1e9 / (1u << 20));
+
+			return result;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename Hasher>
+		static std::vector<ThroughputResult> MeasureThroughputSweep(const Hasher& hasher, uint64_t minKeyLength = 1u, uint64_t maxKeyLength = 1u << 20)
+		{
+			std::vector<ThroughputResult> results;
+
+			for (uint64_t keyLength = minKeyLength; keyLength <= maxKeyLength; keyLength <<= 1)
+			{
+				results.emplace_back(MeasureThroughput(hasher, keyLength, true));
+				results.emplace_back(MeasureThroughput(hasher, keyLength, false));
+			}
+
+			return results;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename Hasher>
+		static double AvalancheBias(const Hasher& hasher, uint32_t keyLength, uint32_t samplesCount = 10000u)
+		{
+			const uint32_t inputBits = keyLength * 8u;
+
+			std::vector<uint32_t> flipCounts(inputBits * Hasher::HashBits, 0u);
+			std::vector<byte> key(keyLength);
+			std::mt19937_64 random(keyLength);
+
+			for (uint32_t sample = 0u; sample != samplesCount; ++sample)
+			{
+				for (auto& keyByte : key)
+				{
+					keyByte = static_cast<byte>(random());
+				}
+
+				const uint64_t baseHash = hasher(key.data(), keyLength, 1u);
+
+				for (uint32_t inputBit = 0u; inputBit != inputBits; ++inputBit)
+				{
+					key[inputBit >> 3] ^= static_cast<byte>(1u << (inputBit & 7u));
+					CountFlips<Hasher>(baseHash ^ hasher(key.data(), keyLength, 1u), flipCounts.data() + inputBit * Hasher::HashBits);
+					key[inputBit >> 3] ^= static_cast<byte>(1u << (inputBit & 7u));
+				}
+			}
+
+			return WorstBias(flipCounts, samplesCount);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Bit independence criterion: for every input bit flip, flips of any two output bits must be uncorrelated.
+		template <typename Hasher>
+		static double BitIndependenceBias(const Hasher& hasher, uint32_t keyLength, uint32_t samplesCount = 1000u)
+		{
+			constexpr uint32_t PairsCount = Hasher::HashBits * Hasher::HashBits;
+
+			const uint32_t inputBits = keyLength * 8u;
+
+			std::vector<uint32_t> pairCounts(PairsCount);
+			std::vector<uint32_t> flipCounts(Hasher::HashBits);
+			std::vector<byte> key(keyLength);
+			std::mt19937_64 random(keyLength + 1u);
+			double worstCorrelation = 0.0;
+
+			for (uint32_t inputBit = 0u; inputBit != inputBits; ++inputBit)
+			{
+				std::fill(pairCounts.begin(), pairCounts.end(), 0u);
+				std::fill(flipCounts.begin(), flipCounts.end(), 0u);
+
+				for (uint32_t sample = 0u; sample != samplesCount; ++sample)
+				{
+					for (auto& keyByte : key)
+					{
+						keyByte = static_cast<byte>(random());
+					}
+
+					const uint64_t baseHash = hasher(key.data(), keyLength, 1u);
+					key[inputBit >> 3] ^= static_cast<byte>(1u << (inputBit & 7u));
+					const uint64_t flippedBits = baseHash ^ hasher(key.data(), keyLength, 1u);
+
+					CountFlips<Hasher>(flippedBits, flipCounts.data());
+
+					for (uint64_t firstBits = flippedBits; firstBits != 0u; firstBits &= firstBits - 1u)
+					{
+						const uint32_t firstBit = static_cast<uint32_t>(__builtin_ctzll(firstBits));
+
+						for (uint64_t secondBits = firstBits & (firstBits - 1u); secondBits != 0u; secondBits &= secondBits - 1u)
+						{
+							++pairCounts[firstBit * Hasher::HashBits + static_cast<uint32_t>(__builtin_ctzll(secondBits))];
+						}
+					}
+				}
+
+				// Pearson correlation of two flip indicators
+				const double samples = static_cast<double>(samplesCount);
+
+				for (uint32_t firstBit = 0u; firstBit != Hasher::HashBits; ++firstBit)
+				{
+					for (uint32_t secondBit = firstBit + 1u; secondBit != Hasher::HashBits; ++secondBit)
+					{
+						const double firstProbability = flipCounts[firstBit] / samples;
+						const double secondProbability = flipCounts[secondBit] / samples;
+						const double pairProbability = pairCounts[firstBit * Hasher::HashBits + secondBit] / samples;
+						const double deviations = sqrt(firstProbability * (1.0 - firstProbability) * secondProbability * (1.0 - secondProbability));
+						const double correlation = deviations > 0.0 ? (pairProbability - firstProbability * secondProbability) / deviations : 1.0;
+
+						worstCorrelation = std::max(worstCorrelation, fabs(correlation));
+					}
+				}
+			}
+
+			return worstCorrelation;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Avalanche of the seed: flipping any seed bit must flip every output bit with probability 1/2.
+		template <typename Hasher>
+		static double SeedSensitivityBias(const Hasher& hasher, uint32_t keyLength, uint32_t samplesCount = 10000u)
+		{
+			if (Hasher::SeedBits == 0u)
+			{
+				return 1.0;
+			}
+
+			std::vector<uint32_t> flipCounts(Hasher::SeedBits * Hasher::HashBits, 0u);
+			std::vector<byte> key(keyLength);
+			std::mt19937_64 random(keyLength + 2u);
+
+			for (uint32_t sample = 0u; sample != samplesCount; ++sample)
+			{
+				for (auto& keyByte : key)
+				{
+					keyByte = static_cast<byte>(random());
+				}
+
+				const uint64_t seed = random();
+				const uint64_t baseHash = hasher(key.data(), keyLength, seed);
+
+				for (uint32_t seedBit = 0u; seedBit != Hasher::SeedBits; ++seedBit)
+				{
+					CountFlips<Hasher>(baseHash ^ hasher(key.data(), keyLength, seed ^ (uint64_t(1u) << seedBit)), flipCounts.data() + seedBit * Hasher::HashBits);
+				}
+			}
+
+			return WorstBias(flipCounts, samplesCount);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename Hasher>
+		static QualityResult MeasureQuality(const Hasher& hasher, uint32_t keyLength = 16u)
+		{
+			QualityResult result;
+			result.m_avalancheBias = AvalancheBias(hasher, keyLength);
+			result.m_bitIndependenceBias = BitIndependenceBias(hasher, keyLength);
+			result.m_seedSensitivityBias = SeedSensitivityBias(hasher, keyLength);
+
+			return result;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Prints the whole throughput table and quality biases for a few typical key lengths.
+		template <typename Hasher>
+		static void Report(std::ostream& output, const char* hasherName, const Hasher& hasher = Hasher())
+		{
+			output << hasherName << std::endl;
+			output << std::setw(10) << "key bytes" << std::setw(14) << "aligned ns" << std::setw(14) << "aligned MB/s" << std::setw(14) << "unaligned ns" << std::setw(16) << "unaligned MB/s" << std::endl;
+
+			const auto throughputResults = MeasureThroughputSweep(hasher);
+
+			for (size_t resultIndex = 0u; resultIndex + 1u < throughputResults.size(); resultIndex += 2u)
+			{
+				const ThroughputResult& alignedResult = throughputResults[resultIndex];
+				const ThroughputResult& unalignedResult = throughputResults[resultIndex + 1u];
+
+				output << std::fixed << std::setprecision(1) <<
+					std::setw(10) << alignedResult.m_keyLength <<
+					std::setw(14) << alignedResult.m_nanosecondsPerHash << std::setw(14) << alignedResult.m_megabytesPerSecond <<
+					std::setw(14) << unalignedResult.m_nanosecondsPerHash << std::setw(16) << unalignedResult.m_megabytesPerSecond << std::endl;
+			}
+
+			output << std::setw(10) << "key bytes" << std::setw(14) << "avalanche" << std::setw(14) << "independence" << std::setw(14) << "seed" << std::endl;
+
+			for (uint32_t keyLength : { 4u, 8u, 16u, 64u })
+			{
+				const QualityResult qualityResult = MeasureQuality(hasher, keyLength);
+
+				output << std::fixed << std::setprecision(4) <<
+					std::setw(10) << keyLength <<
+					std::setw(14) << qualityResult.m_avalancheBias << std::setw(14) << qualityResult.m_bitIndependenceBias << std::setw(14) << qualityResult.m_seedSensitivityBias << std::endl;
+			}
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		template <typename Hasher>
+		forceinline static void CountFlips(uint64_t flippedBits, uint32_t* flipCounts)
+		{
+			for (uint32_t outputBit = 0u; outputBit != Hasher::HashBits; ++outputBit)
+			{
+				flipCounts[outputBit] += static_cast<uint32_t>((flippedBits >> outputBit) & 1u);
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static double WorstBias(const std::vector<uint32_t>& flipCounts, uint32_t samplesCount)
+		{
+			double worstBias = 0.0;
+
+			for (uint32_t flipCount : flipCounts)
+			{
+				worstBias = std::max(worstBias, fabs(static_cast<double>(flipCount) / samplesCount * 2.0 - 1.0));
+			}
+
+			return worstBias;
+		}
+	};
+}
@@ -0,0 +1,154 @@
+#include "platform.h"
+#include "MappedArray.h"
+#include "TreeHash.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	MappedFile::MappedFile() : m_data(nullptr), m_length(0u)
+	{
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	bool MappedFile::Open(const char* path)
+	{
+		Close();
+
+		const int fileDescriptor = open(path, O_RDONLY | O_CLOEXEC);
+
+		if (fileDescriptor < 0)
+		{
+			return false;
+		}
+
+		struct stat fileStat;
+
+		if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size <= 0)
+		{
+			close(fileDescriptor);
+			return false;
+		}
+
+		void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, fileDescriptor, 0);
+
+		// The mapping keeps the file referenced on its own
+		close(fileDescriptor);
+
+		if (data == MAP_FAILED)
+		{
+			return false;
+		}
+
+		m_data = reinterpret_cast<const byte*>(data);
+		m_length = static_cast<uint64_t>(fileStat.st_size);
+
+		return true;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	void MappedFile::Close()
+	{
+		if (m_data)
+		{
+			munmap(const_cast<byte*>(m_data), static_cast<size_t>(m_length));
+
+			m_data = nullptr;
+			m_length = 0u;
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	bool MappedArrayFormat::Save(const char* path, uint32_t typeTag, uint32_t elementSize, const void* elements, uint64_t elementsCount)
+	{
+		const uint64_t elementsLength = elementsCount * elementSize;
+
+		Header header;
+
+		memset(&header, 0, sizeof(header));
+		header.m_tag = Tag;
+		header.m_version = Version;
+		header.m_typeTag = typeTag;
+		header.m_elementSize = elementSize;
+		header.m_elementsCount = elementsCount;
+		header.m_checksum = TreeHash64(elements, elementsLength);
+
+		const std::string temporaryPath = std::string(path) + ".tmp";
+		const int fileDescriptor = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+		if (fileDescriptor < 0)
+		{
+			return false;
+		}
+
+		const auto WriteAll = [fileDescriptor](const void* buffer, uint64_t bufferLength)->bool
+		{
+			const byte* bufferBytes = reinterpret_cast<const byte*>(buffer);
+
+			while (bufferLength)
+			{
+				const ssize_t writtenLength = write(fileDescriptor, bufferBytes, static_cast<size_t>(std::min<uint64_t>(bufferLength, 1u << 30)));
+
+				if (writtenLength < 0 && errno == EINTR)
+				{
+					continue;
+				}
+
+				if (writtenLength <= 0)
+				{
+					return false;
+				}
+
+				bufferBytes += writtenLength;
+				bufferLength -= static_cast<uint64_t>(writtenLength);
+			}
+
+			return true;
+		};
+
+		const bool written = WriteAll(&header, sizeof(header)) && WriteAll(elements, elementsLength);
+
+		if (close(fileDescriptor) != 0 || !written || rename(temporaryPath.c_str(), path) != 0)
+		{
+			unlink(temporaryPath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	const void* MappedArrayFormat::Validate(const MappedFile& mappedFile, uint32_t typeTag, uint32_t elementSize, uint64_t& elementsCount, bool verifyChecksum)
+	{
+		if (mappedFile.Data() == nullptr || mappedFile.Length() < sizeof(Header))
+		{
+			return nullptr;
+		}
+
+		const Header& header = *reinterpret_cast<const Header*>(mappedFile.Data());
+		const uint64_t availableLength = mappedFile.Length() - sizeof(Header);
+
+		if (header.m_tag != Tag || header.m_version != Version || header.m_typeTag != typeTag || header.m_elementSize != elementSize ||
+			header.m_elementsCount > availableLength / elementSize)
+		{
+			return nullptr;
+		}
+
+		const byte* elements = mappedFile.Data() + sizeof(Header);
+
+		if (verifyChecksum && TreeHash64(elements, header.m_elementsCount * elementSize) != header.m_checksum)
+		{
+			return nullptr;
+		}
+
+		elementsCount = header.m_elementsCount;
+
+		return elements;
+	}
+}
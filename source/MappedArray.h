@@ -0,0 +1,166 @@
+#pragma once
+
+#include "FixedArray.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// MappedFile - read-only shared mapping of a whole file
+	//-------------------------------------------------------------------------------------------------
+	class MappedFile : public boost::noncopyable
+	{
+	private:
+		const byte*					m_data;
+		uint64_t					m_length;
+
+	public:
+		MappedFile();
+		~MappedFile();
+
+		bool Open(const char* path);
+		void Close();
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline const byte* Data() const
+		{
+			return m_data;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint64_t Length() const
+		{
+			return m_length;
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// MappedArrayFormat
+	///
+	/// File layout of mappable arrays: a 64 byte header followed by the raw elements, so the elements
+	/// are cache line aligned in the mapping. The header records a caller defined type tag, the element
+	/// size and count, and a TreeHash64 checksum of the elements.
+	//-------------------------------------------------------------------------------------------------
+	class MappedArrayFormat
+	{
+	public:
+		static constexpr uint32_t	Tag = makefourcc('M', 'A', 'R', 'R');
+		static constexpr uint32_t	Version = 1u;
+
+		class Header
+		{
+		public:
+			uint32_t				m_tag;
+			uint32_t				m_version;
+			uint32_t				m_typeTag;
+			uint32_t				m_elementSize;
+			uint64_t				m_elementsCount;
+			uint64_t				m_checksum;
+			uint64_t				m_reserved[4];
+		};
+
+		static_assert(sizeof(Header) == 64u, "Header must keep the elements cache line aligned.");
+
+	public:
+		/// Writes into a temporary file next to path and renames it over path, so processes mapping
+		/// the old file keep seeing consistent data.
+		static bool Save(const char* path, uint32_t typeTag, uint32_t elementSize, const void* elements, uint64_t elementsCount);
+
+		/// Returns the elements of a mapped file, or nullptr when the file does not match.
+		static const void* Validate(const MappedFile& mappedFile, uint32_t typeTag, uint32_t elementSize, uint64_t& elementsCount, bool verifyChecksum);
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// SaveMappedArray - stores an array of trivially copyable elements for MappedArray
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, typename SizeType>
+	inline bool SaveMappedArray(const FixedArrayBase<DataType, SizeType>& array, const char* path, uint32_t typeTag)
+	{
+		static_assert(std::is_trivially_copyable<DataType>::value, "Only trivially copyable elements can be mapped.");
+
+		return MappedArrayFormat::Save(path, typeTag, sizeof(DataType), array.data(), array.size());
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// MappedArray
+	///
+	/// Read-only array backed by a file written with SaveMappedArray(). Loading maps the file and
+	/// checks the header only, so it takes constant time and the pages are shared with every other
+	/// process mapping the same file. The checksum is verified on request, that reads the whole file.
+	/// View() exposes the elements to code working with FixedArrayBase.
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, typename SizeType = uint32_t>
+	class MappedArray : public boost::noncopyable
+	{
+		static_assert(std::is_trivially_copyable<DataType>::value, "Only trivially copyable elements can be mapped.");
+
+	private:
+		MappedFile					m_mappedFile;
+		FixedArray<DataType, MemoryOwnage::ExternalMemory, alignof(DataType), HeapAllocator, SizeType> m_view;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline MappedArray()
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool Load(const char* path, uint32_t typeTag, bool verifyChecksum = false)
+		{
+			Unload();
+
+			uint64_t elementsCount = 0u;
+			const void* elements = m_mappedFile.Open(path) ? MappedArrayFormat::Validate(m_mappedFile, typeTag, sizeof(DataType), elementsCount, verifyChecksum) : nullptr;
+
+			if (elements == nullptr || elementsCount > std::numeric_limits<SizeType>::max())
+			{
+				m_mappedFile.Close();
+				return false;
+			}
+
+			// The mapping is read only, writing through the view faults
+			m_view.SetMemory(const_cast<DataType*>(reinterpret_cast<const DataType*>(elements)), static_cast<SizeType>(elementsCount));
+
+			return true;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void Unload()
+		{
+			m_view.SetMemory(nullptr, 0u);
+			m_mappedFile.Close();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool IsLoaded() const
+		{
+			return m_view.data() != nullptr;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline const FixedArrayBase<DataType, SizeType>& View() const
+		{
+			return m_view;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SizeType size() const
+		{
+			return m_view.size();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline const DataType* data() const
+		{
+			return m_view.data();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename IndexType>
+		inline const DataType& operator[] (IndexType index) const
+		{
+			return m_view[index];
+		}
+	};
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "CpuDispatch.h"
+
 
 namespace std
 {
@@ -50,12 +52,13 @@ namespace std
 
 		constexpr int32_t scaleUpIntoInt32() const
 		{
-			return (m_internal[2] << 24) | (m_internal[1] << 16) | (m_internal[0] << 8) | (~(static_cast<int8_t>(m_internal[2]) >> 7) & 0x000000FF);
+			return static_cast<int32_t>((static_cast<uint32_t>(m_internal[2]) << 24) | (static_cast<uint32_t>(m_internal[1]) << 16) | (static_cast<uint32_t>(m_internal[0]) << 8) |
+				(~(static_cast<int8_t>(m_internal[2]) >> 7) & 0x000000FF));
 		}
 
 		constexpr operator int32_t() const
 		{
-			return ((static_cast<int8_t>(m_internal[2]) >> 7) << 24) | (m_internal[2] << 16) | (m_internal[1] << 8) | m_internal[0];
+			return static_cast<int32_t>((static_cast<uint32_t>(static_cast<int8_t>(m_internal[2])) << 16) | (static_cast<uint32_t>(m_internal[1]) << 8) | m_internal[0]);
 		}
 
 		constexpr operator float() const
@@ -72,6 +75,122 @@ namespace std
 
 	static_assert(sizeof(int24_t) == 3u, "Size of \"int24_t\" class not equal to 24 bit.");
 
+	//-------------------------------------------------------------------------------------------------
+	/// half - IEEE 754 binary16 float
+	///
+	/// Storage type, conversions round to nearest even like F16C does. double goes through float.
+	//-------------------------------------------------------------------------------------------------
+	class half
+	{
+	public:
+		uint16_t					m_internal;
+
+	public:
+		constexpr half() : m_internal(0u)
+		{
+		}
+
+		half(float input) : m_internal(fromFloat(input))
+		{
+		}
+
+		half(double input) : half(static_cast<float>(input))
+		{
+		}
+
+		operator float() const
+		{
+			return toFloat(m_internal);
+		}
+
+		operator double() const
+		{
+			return static_cast<double>(toFloat(m_internal));
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		static uint16_t fromFloat(float input)
+		{
+			uint32_t bits;
+			memcpy(&bits, &input, sizeof(bits));
+
+			const uint32_t sign = (bits >> 16) & 0x8000u;
+			const uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+			// Infinity, NaN keeps its upper payload and becomes quiet
+			if (magnitude >= 0x7F800000u)
+			{
+				return static_cast<uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x0200u | ((magnitude >> 13) & 0x03FFu) : 0u));
+			}
+
+			// 65520 and above round to infinity
+			if (magnitude >= 0x477FF000u)
+			{
+				return static_cast<uint16_t>(sign | 0x7C00u);
+			}
+
+			uint32_t result, remainder, halfway;
+
+			if (magnitude >= 0x38800000u)
+			{
+				result = (magnitude - 0x38000000u) >> 13;
+				remainder = magnitude & 0x1FFFu;
+				halfway = 0x1000u;
+			}
+			else if (magnitude > 0x33000000u)
+			{
+				// Subnormal, the mantissa with its implicit bit in units of 2^-24
+				const uint32_t shift = 126u - (magnitude >> 23);
+				const uint32_t mantissa = (magnitude & 0x007FFFFFu) | 0x00800000u;
+
+				result = mantissa >> shift;
+				remainder = mantissa & ((1u << shift) - 1u);
+				halfway = 1u << (shift - 1u);
+			}
+			else
+			{
+				return static_cast<uint16_t>(sign);
+			}
+
+			// A carry out of the mantissa correctly moves to the next exponent
+			result += (remainder > halfway || (remainder == halfway && (result & 1u))) ? 1u : 0u;
+
+			return static_cast<uint16_t>(sign | result);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static float toFloat(uint16_t input)
+		{
+			const uint32_t sign = static_cast<uint32_t>(input & 0x8000u) << 16;
+			const uint32_t exponent = (input >> 10) & 0x1Fu;
+			const uint32_t mantissa = input & 0x03FFu;
+			uint32_t bits;
+
+			if (exponent == 0x1Fu)
+			{
+				bits = sign | 0x7F800000u | (mantissa << 13) | (mantissa ? 0x00400000u : 0u);
+			}
+			else if (exponent != 0u)
+			{
+				bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+			}
+			else
+			{
+				const float subnormal = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+
+				return sign ? -subnormal : subnormal;
+			}
+
+			float result;
+			memcpy(&result, &bits, sizeof(result));
+
+			return result;
+		}
+	};
+
+	static_assert(sizeof(half) == 2u, "Size of \"half\" class not equal to 16 bit.");
+
 	//-------------------------------------------------------------------------------------------------
 	/// Limits
 	//-------------------------------------------------------------------------------------------------
@@ -89,9 +208,26 @@ namespace std
 }
 
 using std::int24_t;
+using std::half;
 
 namespace aux
 {
+	//-------------------------------------------------------------------------------------------------
+	/// NextPowerOfTwo
+	//-------------------------------------------------------------------------------------------------
+	template <typename IntegerType>
+	constexpr IntegerType NextPowerOfTwo(IntegerType value)
+	{
+		IntegerType result = 1u;
+
+		while (result < value)
+		{
+			result <<= 1;
+		}
+
+		return result;
+	}
+
 	//-------------------------------------------------------------------------------------------------
 	/// DummyHash
 	//-------------------------------------------------------------------------------------------------
@@ -112,6 +248,7 @@ namespace aux
 	{
 		SignedInteger = 0u,
 		Float,
+		Half,
 		Other
 	};
 
@@ -143,6 +280,208 @@ namespace aux
 		static constexpr TypeClass	this_class = TypeClass::Float;
 	};
 
+	template <typename input_t>
+	class type_classifier<input_t, typename std::enable_if<std::is_same<input_t, half>::value>::type>
+	{
+	public:
+		static constexpr TypeClass	this_class = TypeClass::Half;
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// sample_lanes - four samples of a type in the int32 lanes of an SSE register
+	//-------------------------------------------------------------------------------------------------
+	template <typename sample_t>
+	class sample_lanes
+	{
+	public:
+		static constexpr bool		vectorized = false;
+	};
+
+	template <>
+	class sample_lanes<int16_t>
+	{
+	public:
+		static constexpr bool		vectorized = true;
+		static constexpr uint32_t	bits = 16u;
+
+		forceinline static __m128i load(const int16_t* input)
+		{
+			return _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(input)));
+		}
+
+		/// Lanes out of the int16_t range saturate.
+		forceinline static void store(int16_t* output, __m128i lanes)
+		{
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(output), _mm_packs_epi32(lanes, lanes));
+		}
+	};
+
+	template <>
+	class sample_lanes<int24_t>
+	{
+	public:
+		static constexpr bool		vectorized = true;
+		static constexpr uint32_t	bits = 24u;
+
+		/// Reads exactly 12 bytes, the samples are spread into the upper bytes of lanes and shifted down.
+		forceinline static __m128i load(const int24_t* input)
+		{
+			int32_t lastBytes;
+			memcpy(&lastBytes, reinterpret_cast<const byte*>(input) + 8u, sizeof(lastBytes));
+
+			const __m128i packed = _mm_insert_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(input)), lastBytes, 2);
+
+			return _mm_srai_epi32(_mm_shuffle_epi8(packed, _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11)), 8);
+		}
+
+		/// Lanes out of the int24_t range saturate, writes exactly 12 bytes.
+		forceinline static void store(int24_t* output, __m128i lanes)
+		{
+			const __m128i clamped = _mm_max_epi32(_mm_min_epi32(lanes, _mm_set1_epi32(0x7FFFFF)), _mm_set1_epi32(-0x7FFFFF - 1));
+			const __m128i packed = _mm_shuffle_epi8(clamped, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+			const int32_t lastBytes = _mm_extract_epi32(packed, 2);
+
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(output), packed);
+			memcpy(reinterpret_cast<byte*>(output) + 8u, &lastBytes, sizeof(lastBytes));
+		}
+	};
+
+	template <>
+	class sample_lanes<int32_t>
+	{
+	public:
+		static constexpr bool		vectorized = true;
+		static constexpr uint32_t	bits = 32u;
+
+		forceinline static __m128i load(const int32_t* input)
+		{
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+		}
+
+		forceinline static void store(int32_t* output, __m128i lanes)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output), lanes);
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// SamplesKernels
+	///
+	/// Vector part of samples_converter. The kernels are compiled for every IsaLevel in the
+	/// SamplesKernels*.cpp files and picked through CpuDispatch. A kernel converts whole groups of
+	/// 8 samples and returns how many samples it converted, samples_converter finishes the tail with
+	/// its scalar loop. Every level gives results bit-identical with the scalar loops.
+	//-------------------------------------------------------------------------------------------------
+	enum class SampleType : uint32_t
+	{
+		Int16 = 0u,
+		Int24,
+		Int32,
+		Float,
+		Double,
+		Half,
+		Other
+	};
+
+	constexpr uint32_t				SampleTypesCount = static_cast<uint32_t>(SampleType::Other);
+
+	template <typename sample_t>
+	class sample_type : public std::integral_constant<SampleType, SampleType::Other>
+	{
+	};
+
+	template <>
+	class sample_type<int16_t> : public std::integral_constant<SampleType, SampleType::Int16>
+	{
+	};
+
+	template <>
+	class sample_type<int24_t> : public std::integral_constant<SampleType, SampleType::Int24>
+	{
+	};
+
+	template <>
+	class sample_type<int32_t> : public std::integral_constant<SampleType, SampleType::Int32>
+	{
+	};
+
+	template <>
+	class sample_type<float> : public std::integral_constant<SampleType, SampleType::Float>
+	{
+	};
+
+	template <>
+	class sample_type<double> : public std::integral_constant<SampleType, SampleType::Double>
+	{
+	};
+
+	template <>
+	class sample_type<half> : public std::integral_constant<SampleType, SampleType::Half>
+	{
+	};
+
+	typedef uint64_t (*SamplesKernel)(const void* inputBuffer, void* outputBuffer, uint64_t samplesCount);
+
+	class SamplesKernels
+	{
+	public:
+		class Table
+		{
+		public:
+			SamplesKernel			m_kernels[SampleTypesCount][SampleTypesCount];
+		};
+
+	public:
+		/// Kernel of the active level, pairs without a kernel get one converting nothing.
+		static SamplesKernel Get(SampleType inputType, SampleType outputType);
+
+		/// Kernels of a level, which the CPU must support.
+		static const Table& LevelTable(IsaLevel level);
+
+	private:
+		static const Table& Sse41Table();
+		static const Table& AvxTable();
+		static const Table& Avx2Table();
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// samples_vector_converter - forwards to SamplesKernels when both sample types have kernels
+	//-------------------------------------------------------------------------------------------------
+	template <typename input_t, typename output_t, typename = void>
+	class samples_vector_converter
+	{
+	public:
+		forceinline static uint64_t convert(const input_t* inputBuffer, output_t* outputBuffer, uint64_t samplesCount)
+		{
+			return 0u;
+		}
+	};
+
+	template <typename input_t, typename output_t>
+	class samples_vector_converter<input_t, output_t, typename std::enable_if<sample_type<input_t>::value != SampleType::Other && sample_type<output_t>::value != SampleType::Other>::type>
+	{
+	public:
+		forceinline static uint64_t convert(const input_t* inputBuffer, output_t* outputBuffer, uint64_t samplesCount)
+		{
+			return samplesCount >= 8u ? SamplesKernels::Get(sample_type<input_t>::value, sample_type<output_t>::value)(inputBuffer, outputBuffer, samplesCount) : 0u;
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// scale_down_sample - inverse of the widening converters, which fill the low bits of positive
+	/// samples with ones. The fill is subtracted before rounding half up, so a widened sample narrows
+	/// back to itself. A result of the opposite sign to the input is only one step off, the xor turns
+	/// it into 0 or -1. SamplesKernels ops_t::scale_down computes the same.
+	//-------------------------------------------------------------------------------------------------
+	template <uint32_t shift>
+	forceinline int32_t scale_down_sample(int32_t input)
+	{
+		const int32_t sign = input >> 31;
+		const int32_t rounded = (input - (~sign & ((1 << shift) - 1)) + (1 << (shift - 1u))) >> shift;
+
+		return rounded ^ -static_cast<int32_t>(rounded == ~sign);
+	}
+
 	//-------------------------------------------------------------------------------------------------
 	/// samples_converter
 	//-------------------------------------------------------------------------------------------------
@@ -150,7 +489,7 @@ namespace aux
 	class samples_converter
 	{
 	public:
-		forceinline static void convert(const void* inputBuffer, output_t* outputBuffer, uint32_t samplesCount)
+		forceinline static void convert(const void* inputBuffer, output_t* outputBuffer, uint64_t samplesCount)
 		{
 			static_assert(std::is_same<input_t, output_t>::value, "Invalid input or output type.");
 
@@ -165,14 +504,17 @@ namespace aux
 	class samples_converter<int16_t, int32_t, TypeClass::SignedInteger, TypeClass::SignedInteger>
 	{
 	public:
-		forceinline static void convert(const void* inputBuffer, int32_t* outputBuffer, uint32_t samplesCount)
+		forceinline static void convert(const void* inputBuffer, int32_t* outputBuffer, uint64_t samplesCount)
 		{
 			const int16_t* inputBufferStart = reinterpret_cast<const int16_t*>(inputBuffer);
 			const int16_t* inputBufferEnd = inputBufferStart + samplesCount;
+			const uint64_t vectorSamplesCount = samples_vector_converter<int16_t, int32_t>::convert(inputBufferStart, outputBuffer, samplesCount);
+
+			outputBuffer += vectorSamplesCount;
 
-			for (auto* inputIter = inputBufferStart; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
+			for (auto* inputIter = inputBufferStart + vectorSamplesCount; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
 			{
-				*outputBuffer = (static_cast<int32_t>(*inputIter) << 16) | (~(*inputIter >> 15) & 0x0000FFFF);
+				*outputBuffer = static_cast<int32_t>((static_cast<uint32_t>(*inputIter) << 16) | (~(*inputIter >> 15) & 0x0000FFFF));
 			}
 		}
 	};
@@ -184,9 +526,18 @@ namespace aux
 	class samples_converter<int16_t, int24_t, TypeClass::SignedInteger, TypeClass::SignedInteger>
 	{
 	public:
-		forceinline static void convert(const void* inputBuffer, int24_t* outputBuffer, uint32_t samplesCount)
+		forceinline static void convert(const void* inputBuffer, int24_t* outputBuffer, uint64_t samplesCount)
 		{
-			assert(false);
+			const int16_t* inputBufferStart = reinterpret_cast<const int16_t*>(inputBuffer);
+			const int16_t* inputBufferEnd = inputBufferStart + samplesCount;
+			const uint64_t vectorSamplesCount = samples_vector_converter<int16_t, int24_t>::convert(inputBufferStart, outputBuffer, samplesCount);
+
+			outputBuffer += vectorSamplesCount;
+
+			for (auto* inputIter = inputBufferStart + vectorSamplesCount; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
+			{
+				*outputBuffer = static_cast<int32_t>((static_cast<uint32_t>(*inputIter) << 8) | (~(*inputIter >> 15) & 0x000000FF));
+			}
 		}
 	};
 
@@ -197,9 +548,18 @@ namespace aux
 	class samples_converter<int24_t, int16_t, TypeClass::SignedInteger, TypeClass::SignedInteger>
 	{
 	public:
-		forceinline static void convert(const void* inputBuffer, int16_t* outputBuffer, uint32_t samplesCount)
+		forceinline static void convert(const void* inputBuffer, int16_t* outputBuffer, uint64_t samplesCount)
 		{
-			assert(false);
+			const int24_t* inputBufferStart = reinterpret_cast<const int24_t*>(inputBuffer);
+			const int24_t* inputBufferEnd = inputBufferStart + samplesCount;
+			const uint64_t vectorSamplesCount = samples_vector_converter<int24_t, int16_t>::convert(inputBufferStart, outputBuffer, samplesCount);
+
+			outputBuffer += vectorSamplesCount;
+
+			for (auto* inputIter = inputBufferStart + vectorSamplesCount; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
+			{
+				*outputBuffer = static_cast<int16_t>(std::min(scale_down_sample<8u>(*inputIter), 0x7FFF));
+			}
 		}
 	};
 
@@ -210,12 +570,15 @@ namespace aux
 	class samples_converter<int24_t, int32_t, TypeClass::SignedInteger, TypeClass::SignedInteger>
 	{
 	public:
-		forceinline static void convert(const void* inputBuffer, int32_t* outputBuffer, uint32_t samplesCount)
+		forceinline static void convert(const void* inputBuffer, int32_t* outputBuffer, uint64_t samplesCount)
 		{
 			const int24_t* inputBufferStart = reinterpret_cast<const int24_t*>(inputBuffer);
 			const int24_t* inputBufferEnd = inputBufferStart + samplesCount;
+			const uint64_t vectorSamplesCount = samples_vector_converter<int24_t, int32_t>::convert(inputBufferStart, outputBuffer, samplesCount);
+
+			outputBuffer += vectorSamplesCount;
 
-			for (auto* inputIter = inputBufferStart; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
+			for (auto* inputIter = inputBufferStart + vectorSamplesCount; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
 			{
 				*outputBuffer = inputIter->scaleUpIntoInt32();
 			}
@@ -229,9 +592,18 @@ namespace aux
 	class samples_converter<int32_t, int16_t, TypeClass::SignedInteger, TypeClass::SignedInteger>
 	{
 	public:
-		forceinline static void convert(const void* inputBuffer, int16_t* outputBuffer, uint32_t samplesCount)
+		forceinline static void convert(const void* inputBuffer, int16_t* outputBuffer, uint64_t samplesCount)
 		{
-			assert(false);
+			const int32_t* inputBufferStart = reinterpret_cast<const int32_t*>(inputBuffer);
+			const int32_t* inputBufferEnd = inputBufferStart + samplesCount;
+			const uint64_t vectorSamplesCount = samples_vector_converter<int32_t, int16_t>::convert(inputBufferStart, outputBuffer, samplesCount);
+
+			outputBuffer += vectorSamplesCount;
+
+			for (auto* inputIter = inputBufferStart + vectorSamplesCount; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
+			{
+				*outputBuffer = static_cast<int16_t>(std::min(scale_down_sample<16u>(*inputIter), 0x7FFF));
+			}
 		}
 	};
 
@@ -242,9 +614,18 @@ namespace aux
 	class samples_converter<int32_t, int24_t, TypeClass::SignedInteger, TypeClass::SignedInteger>
 	{
 	public:
-		forceinline static void convert(const void* inputBuffer, int24_t* outputBuffer, uint32_t samplesCount)
+		forceinline static void convert(const void* inputBuffer, int24_t* outputBuffer, uint64_t samplesCount)
 		{
-			assert(false);
+			const int32_t* inputBufferStart = reinterpret_cast<const int32_t*>(inputBuffer);
+			const int32_t* inputBufferEnd = inputBufferStart + samplesCount;
+			const uint64_t vectorSamplesCount = samples_vector_converter<int32_t, int24_t>::convert(inputBufferStart, outputBuffer, samplesCount);
+
+			outputBuffer += vectorSamplesCount;
+
+			for (auto* inputIter = inputBufferStart + vectorSamplesCount; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
+			{
+				*outputBuffer = std::min(scale_down_sample<8u>(*inputIter), 0x7FFFFF);
+			}
 		}
 	};
 
@@ -260,12 +641,15 @@ namespace aux
 		static constexpr output_t	Multiplier = One / (MaxInput + One);
 
 	public:
-		forceinline static void convert(const void* inputBuffer, output_t* outputBuffer, uint32_t samplesCount)
+		forceinline static void convert(const void* inputBuffer, output_t* outputBuffer, uint64_t samplesCount)
 		{
 			const input_t* inputBufferStart = reinterpret_cast<const input_t*>(inputBuffer);
 			const input_t* inputBufferEnd = inputBufferStart + samplesCount;
+			const uint64_t vectorSamplesCount = samples_vector_converter<input_t, output_t>::convert(inputBufferStart, outputBuffer, samplesCount);
 
-			for (auto* inputIter = inputBufferStart; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
+			outputBuffer += vectorSamplesCount;
+
+			for (auto* inputIter = inputBufferStart + vectorSamplesCount; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
 			{
 				*outputBuffer = static_cast<output_t>(*inputIter) * Multiplier;
 			}
@@ -274,29 +658,32 @@ namespace aux
 
 	//-------------------------------------------------------------------------------------------------
 	///	float/double to int[x]_t
+	///
+	/// Scales by 2^(bits - 1) and truncates, values out of [-1, 1) saturate. NaN gives the minimum.
 	//-------------------------------------------------------------------------------------------------
 	template <typename input_t, typename output_t>
 	class samples_converter<input_t, output_t, TypeClass::Float, TypeClass::SignedInteger>
 	{
 	private:
-		static constexpr input_t	One = static_cast<input_t>(1);
-		static constexpr input_t	MaxOutput = static_cast<input_t>(std::numeric_limits<output_t>::max());
-		static constexpr input_t	Multiplier = One / (MaxOutput + One);
+		static constexpr input_t	MinOutput = static_cast<input_t>(std::numeric_limits<output_t>::min());
+		static constexpr input_t	Multiplier = -MinOutput;
 
 	public:
-		forceinline static void convert(const void* inputBuffer, output_t* outputBuffer, uint32_t samplesCount)
+		forceinline static void convert(const void* inputBuffer, output_t* outputBuffer, uint64_t samplesCount)
 		{
 			const input_t* inputBufferStart = reinterpret_cast<const input_t*>(inputBuffer);
 			const input_t* inputBufferEnd = inputBufferStart + samplesCount;
+			const uint64_t vectorSamplesCount = samples_vector_converter<input_t, output_t>::convert(inputBufferStart, outputBuffer, samplesCount);
+
+			outputBuffer += vectorSamplesCount;
 
-			for (auto* inputIter = inputBufferStart; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
+			for (auto* inputIter = inputBufferStart + vectorSamplesCount; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
 			{
-				// g++ don't recognize MaxOutput at link time
-#ifdef _WIN32
-				*outputBuffer = static_cast<output_t>(std::min(*inputIter * Multiplier, MaxOutput));
-#else
-				*outputBuffer = static_cast<output_t>(std::min(*inputIter * Multiplier, static_cast<input_t>(std::numeric_limits<output_t>::max())));
-#endif
+				const input_t scaledInput = *inputIter * Multiplier;
+
+				// Multiplier is the first value past the maximum, it is exact for any output unlike the maximum itself
+				*outputBuffer = scaledInput > MinOutput ?
+					(scaledInput < Multiplier ? static_cast<output_t>(scaledInput) : std::numeric_limits<output_t>::max()) : std::numeric_limits<output_t>::min();
 			}
 		}
 	};
@@ -308,12 +695,15 @@ namespace aux
 	class samples_converter<float, double, TypeClass::Float, TypeClass::Float>
 	{
 	public:
-		forceinline static void convert(const void* inputBuffer, double* outputBuffer, uint32_t samplesCount)
+		forceinline static void convert(const void* inputBuffer, double* outputBuffer, uint64_t samplesCount)
 		{
 			const float* inputBufferStart = reinterpret_cast<const float*>(inputBuffer);
 			const float* inputBufferEnd = inputBufferStart + samplesCount;
+			const uint64_t vectorSamplesCount = samples_vector_converter<float, double>::convert(inputBufferStart, outputBuffer, samplesCount);
+
+			outputBuffer += vectorSamplesCount;
 
-			for (auto* inputIter = inputBufferStart; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
+			for (auto* inputIter = inputBufferStart + vectorSamplesCount; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
 			{
 				*outputBuffer = static_cast<double>(*inputIter);
 			}
@@ -327,18 +717,133 @@ namespace aux
 	class samples_converter<double, float, TypeClass::Float, TypeClass::Float>
 	{
 	public:
-		forceinline static void convert(const void* inputBuffer, float* outputBuffer, uint32_t samplesCount)
+		forceinline static void convert(const void* inputBuffer, float* outputBuffer, uint64_t samplesCount)
 		{
 			const double* inputBufferStart = reinterpret_cast<const double*>(inputBuffer);
 			const double* inputBufferEnd = inputBufferStart + samplesCount;
+			const uint64_t vectorSamplesCount = samples_vector_converter<double, float>::convert(inputBufferStart, outputBuffer, samplesCount);
+
+			outputBuffer += vectorSamplesCount;
+
+			for (auto* inputIter = inputBufferStart + vectorSamplesCount; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
+			{
+				*outputBuffer = static_cast<float>(*inputIter);
+			}
+		}
+	};
 
-			for (auto* inputIter = inputBufferStart; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
+	//-------------------------------------------------------------------------------------------------
+	///	half to float
+	//-------------------------------------------------------------------------------------------------
+	template <>
+	class samples_converter<half, float, TypeClass::Half, TypeClass::Float>
+	{
+	public:
+		forceinline static void convert(const void* inputBuffer, float* outputBuffer, uint64_t samplesCount)
+		{
+			const half* inputBufferStart = reinterpret_cast<const half*>(inputBuffer);
+			const half* inputBufferEnd = inputBufferStart + samplesCount;
+			const uint64_t vectorSamplesCount = samples_vector_converter<half, float>::convert(inputBufferStart, outputBuffer, samplesCount);
+
+			outputBuffer += vectorSamplesCount;
+
+			for (auto* inputIter = inputBufferStart + vectorSamplesCount; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
 			{
 				*outputBuffer = static_cast<float>(*inputIter);
 			}
 		}
 	};
 
+	//-------------------------------------------------------------------------------------------------
+	///	float to half
+	//-------------------------------------------------------------------------------------------------
+	template <>
+	class samples_converter<float, half, TypeClass::Float, TypeClass::Half>
+	{
+	public:
+		forceinline static void convert(const void* inputBuffer, half* outputBuffer, uint64_t samplesCount)
+		{
+			const float* inputBufferStart = reinterpret_cast<const float*>(inputBuffer);
+			const float* inputBufferEnd = inputBufferStart + samplesCount;
+			const uint64_t vectorSamplesCount = samples_vector_converter<float, half>::convert(inputBufferStart, outputBuffer, samplesCount);
+
+			outputBuffer += vectorSamplesCount;
+
+			for (auto* inputIter = inputBufferStart + vectorSamplesCount; inputIter != inputBufferEnd; ++inputIter, ++outputBuffer)
+			{
+				*outputBuffer = half(*inputIter);
+			}
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	///	half to half
+	//-------------------------------------------------------------------------------------------------
+	template <>
+	class samples_converter<half, half, TypeClass::Half, TypeClass::Half>
+	{
+	public:
+		forceinline static void convert(const void* inputBuffer, half* outputBuffer, uint64_t samplesCount)
+		{
+			memcpy(outputBuffer, inputBuffer, samplesCount * sizeof(half));
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	///	half to anything else
+	///
+	/// Goes through float in blocks staying in L1 cache, both steps use the vector kernels. half to
+	/// float is exact, so the results equal converting the float values.
+	//-------------------------------------------------------------------------------------------------
+	template <typename output_t, TypeClass output_class>
+	class samples_converter<half, output_t, TypeClass::Half, output_class>
+	{
+	private:
+		static constexpr uint32_t	StagingLength = 256u;
+
+	public:
+		static void convert(const void* inputBuffer, output_t* outputBuffer, uint64_t samplesCount)
+		{
+			const half* input = reinterpret_cast<const half*>(inputBuffer);
+			alignas(32) float staging[StagingLength];
+
+			for (uint64_t blockStart = 0u; blockStart < samplesCount; blockStart += StagingLength)
+			{
+				const uint64_t blockLength = std::min<uint64_t>(StagingLength, samplesCount - blockStart);
+
+				samples_converter<half, float>::convert(input + blockStart, staging, blockLength);
+				samples_converter<float, output_t>::convert(staging, outputBuffer + blockStart, blockLength);
+			}
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	///	anything else to half
+	///
+	/// Goes through float in blocks staying in L1 cache, so int32_t and double are rounded twice.
+	//-------------------------------------------------------------------------------------------------
+	template <typename input_t, TypeClass input_class>
+	class samples_converter<input_t, half, input_class, TypeClass::Half>
+	{
+	private:
+		static constexpr uint32_t	StagingLength = 256u;
+
+	public:
+		static void convert(const void* inputBuffer, half* outputBuffer, uint64_t samplesCount)
+		{
+			const input_t* input = reinterpret_cast<const input_t*>(inputBuffer);
+			alignas(32) float staging[StagingLength];
+
+			for (uint64_t blockStart = 0u; blockStart < samplesCount; blockStart += StagingLength)
+			{
+				const uint64_t blockLength = std::min<uint64_t>(StagingLength, samplesCount - blockStart);
+
+				samples_converter<input_t, float>::convert(input + blockStart, staging, blockLength);
+				samples_converter<float, half>::convert(staging, outputBuffer + blockStart, blockLength);
+			}
+		}
+	};
+
 	//-------------------------------------------------------------------------------------------------
 	/// Fast itoa implementation.
 	/// Last update - Apr 13 2015
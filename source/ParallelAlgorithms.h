@@ -0,0 +1,382 @@
+#pragma once
+
+#include "FixedArray.h"
+#include "Miscellaneous.h"
+#include "ThreadPool.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// Parallel algorithms
+	///
+	/// Data parallel passes over spans (pointer and count) and FixedArrays. The range is cut into at
+	/// most ParallelMaxChunksCount chunks, which the pool threads pick up one by one, so fast threads
+	/// take over the work of slow ones. Chunk boundaries depend only on the elements count, hence
+	/// ParallelReduce() and ParallelPrefixSum() give the same result for any threads count, even for
+	/// floating point. Ranges shorter than ParallelSerialThreshold are processed on the calling thread.
+	//-------------------------------------------------------------------------------------------------
+	constexpr uint64_t				ParallelSerialThreshold = 1u << 15;
+	constexpr uint64_t				ParallelMinChunkLength = 1u << 12;
+	constexpr uint64_t				ParallelMaxChunksCount = 256u;
+	constexpr uint64_t				ParallelSamplesChunkBytes = 1u << 18;
+
+	//-------------------------------------------------------------------------------------------------
+	/// ParallelChunking - splits elements count into chunks, whole cache lines for any element size
+	//-------------------------------------------------------------------------------------------------
+	class ParallelChunking
+	{
+	private:
+		uint64_t					m_elementsCount;
+		uint64_t					m_chunkLength;
+		uint64_t					m_chunksCount;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline ParallelChunking(uint64_t elementsCount) : m_elementsCount(elementsCount)
+		{
+			const uint64_t chunkLength = std::max(ParallelMinChunkLength, (elementsCount + ParallelMaxChunksCount - 1u) / ParallelMaxChunksCount);
+
+			m_chunkLength = (chunkLength + 63u) & ~uint64_t(63u);
+			m_chunksCount = (elementsCount + m_chunkLength - 1u) / m_chunkLength;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Chunks of a given length, rounded up to whole cache lines too.
+		inline ParallelChunking(uint64_t elementsCount, uint64_t chunkLength) : m_elementsCount(elementsCount)
+		{
+			m_chunkLength = (std::max<uint64_t>(chunkLength, 1u) + 63u) & ~uint64_t(63u);
+			m_chunksCount = (elementsCount + m_chunkLength - 1u) / m_chunkLength;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint64_t ChunksCount() const
+		{
+			return m_chunksCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint64_t ChunkStart(uint64_t chunkIndex) const
+		{
+			return chunkIndex * m_chunkLength;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint64_t ChunkEnd(uint64_t chunkIndex) const
+		{
+			return std::min(m_elementsCount, (chunkIndex + 1u) * m_chunkLength);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline static bool IsSerial(uint64_t elementsCount, const ThreadPool& threadPool)
+		{
+			return elementsCount < ParallelSerialThreshold || threadPool.ThreadsCount() == 1u;
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// ParallelFill
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType>
+	inline void ParallelFill(DataType* data, uint64_t elementsCount, const DataType& value, ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		if (ParallelChunking::IsSerial(elementsCount, threadPool))
+		{
+			std::fill(data, data + elementsCount, value);
+			return;
+		}
+
+		const ParallelChunking chunking(elementsCount);
+
+		threadPool.ParallelFor(chunking.ChunksCount(), [&](uint64_t chunkIndex)
+		{
+			std::fill(data + chunking.ChunkStart(chunkIndex), data + chunking.ChunkEnd(chunkIndex), value);
+		});
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, typename SizeType>
+	inline void ParallelFill(FixedArrayBase<DataType, SizeType>& array, const DataType& value, ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		ParallelFill(array.data(), array.size(), value, threadPool);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// ParallelTransform - output[i] = transformFunction(input[i]), output may be the input
+	//-------------------------------------------------------------------------------------------------
+	template <typename InputType, typename OutputType, typename TransformFunctionType>
+	inline void ParallelTransform(const InputType* input, OutputType* output, uint64_t elementsCount, TransformFunctionType transformFunction, ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		if (ParallelChunking::IsSerial(elementsCount, threadPool))
+		{
+			std::transform(input, input + elementsCount, output, transformFunction);
+			return;
+		}
+
+		const ParallelChunking chunking(elementsCount);
+
+		threadPool.ParallelFor(chunking.ChunksCount(), [&](uint64_t chunkIndex)
+		{
+			const uint64_t chunkStart = chunking.ChunkStart(chunkIndex);
+
+			std::transform(input + chunkStart, input + chunking.ChunkEnd(chunkIndex), output + chunkStart, transformFunction);
+		});
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename InputType, typename OutputType, typename SizeType, typename TransformFunctionType>
+	inline void ParallelTransform(const FixedArrayBase<InputType, SizeType>& input, FixedArrayBase<OutputType, SizeType>& output, TransformFunctionType transformFunction, ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		assert(input.size() == output.size());
+
+		ParallelTransform(input.data(), output.data(), input.size(), transformFunction, threadPool);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// ParallelTransformReduce - folds transformFunction(data[i]) with reduceFunction, starting from
+	/// identity in every chunk; reduceFunction also combines the chunk results in order.
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, typename ResultType, typename ReduceFunctionType, typename TransformFunctionType>
+	inline ResultType ParallelTransformReduce(const DataType* data, uint64_t elementsCount, ResultType identity, ReduceFunctionType reduceFunction, TransformFunctionType transformFunction, ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		const ParallelChunking chunking(elementsCount);
+		const auto ReduceChunk = [&](uint64_t chunkIndex)->ResultType
+		{
+			ResultType chunkResult = identity;
+
+			for (uint64_t elementIndex = chunking.ChunkStart(chunkIndex), chunkEnd = chunking.ChunkEnd(chunkIndex); elementIndex != chunkEnd; ++elementIndex)
+			{
+				chunkResult = reduceFunction(chunkResult, transformFunction(data[elementIndex]));
+			}
+
+			return chunkResult;
+		};
+
+		if (ParallelChunking::IsSerial(elementsCount, threadPool))
+		{
+			// Same chunks as the parallel path, so the result does not depend on the threads count
+			ResultType result = identity;
+
+			for (uint64_t chunkIndex = 0u; chunkIndex != chunking.ChunksCount(); ++chunkIndex)
+			{
+				result = reduceFunction(result, ReduceChunk(chunkIndex));
+			}
+
+			return result;
+		}
+
+		FixedArray<ResultType> chunkResults(static_cast<uint32_t>(chunking.ChunksCount()), identity);
+
+		threadPool.ParallelFor(chunking.ChunksCount(), [&](uint64_t chunkIndex)
+		{
+			chunkResults[chunkIndex] = ReduceChunk(chunkIndex);
+		});
+
+		ResultType result = identity;
+
+		for (uint32_t chunkIndex = 0u; chunkIndex != chunkResults.size(); ++chunkIndex)
+		{
+			result = reduceFunction(result, chunkResults[chunkIndex]);
+		}
+
+		return result;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// ParallelReduce - reduceFunction must accept (ResultType, DataType) and (ResultType, ResultType),
+	/// like std::reduce.
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, typename ResultType, typename ReduceFunctionType>
+	inline ResultType ParallelReduce(const DataType* data, uint64_t elementsCount, ResultType identity, ReduceFunctionType reduceFunction, ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		return ParallelTransformReduce(data, elementsCount, identity, reduceFunction, [](const DataType& element)->const DataType& { return element; }, threadPool);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, typename SizeType, typename ResultType, typename ReduceFunctionType>
+	inline ResultType ParallelReduce(const FixedArrayBase<DataType, SizeType>& array, ResultType identity, ReduceFunctionType reduceFunction, ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		return ParallelReduce(array.data(), array.size(), identity, reduceFunction, threadPool);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// ParallelPrefixSum - inclusive scan, output[i] = input[0] + ... + input[i], output may be the input.
+	/// Chunk totals are scanned first, then every chunk is scanned again starting from its offset.
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, typename ScanFunctionType = std::plus<DataType> >
+	inline void ParallelPrefixSum(const DataType* input, DataType* output, uint64_t elementsCount, ScanFunctionType scanFunction = ScanFunctionType(), ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		if (elementsCount == 0u)
+		{
+			return;
+		}
+
+		const ParallelChunking chunking(elementsCount);
+		const auto ChunkTotal = [&](uint64_t chunkIndex)->DataType
+		{
+			const uint64_t chunkEnd = chunking.ChunkEnd(chunkIndex);
+			DataType chunkTotal = input[chunking.ChunkStart(chunkIndex)];
+
+			for (uint64_t elementIndex = chunking.ChunkStart(chunkIndex) + 1u; elementIndex != chunkEnd; ++elementIndex)
+			{
+				chunkTotal = scanFunction(chunkTotal, input[elementIndex]);
+			}
+
+			return chunkTotal;
+		};
+		const auto ScanChunk = [&](uint64_t chunkIndex, const DataType* chunkOffset)
+		{
+			const uint64_t chunkStart = chunking.ChunkStart(chunkIndex);
+			const uint64_t chunkEnd = chunking.ChunkEnd(chunkIndex);
+
+			DataType runningSum = chunkOffset ? scanFunction(*chunkOffset, input[chunkStart]) : input[chunkStart];
+			output[chunkStart] = runningSum;
+
+			for (uint64_t elementIndex = chunkStart + 1u; elementIndex != chunkEnd; ++elementIndex)
+			{
+				runningSum = scanFunction(runningSum, input[elementIndex]);
+				output[elementIndex] = runningSum;
+			}
+		};
+
+		if (ParallelChunking::IsSerial(elementsCount, threadPool))
+		{
+			// Same chunks and order of operations as the parallel path, so the result does not depend
+			// on the threads count; the total is taken before an in-place scan overwrites the chunk
+			DataType chunkOffset = DataType();
+
+			for (uint64_t chunkIndex = 0u; chunkIndex != chunking.ChunksCount(); ++chunkIndex)
+			{
+				const bool lastChunk = chunkIndex + 1u == chunking.ChunksCount();
+				const DataType chunkTotal = lastChunk ? DataType() : ChunkTotal(chunkIndex);
+
+				ScanChunk(chunkIndex, chunkIndex ? &chunkOffset : nullptr);
+
+				if (!lastChunk)
+				{
+					chunkOffset = chunkIndex ? scanFunction(chunkOffset, chunkTotal) : chunkTotal;
+				}
+			}
+
+			return;
+		}
+
+		FixedArray<DataType> chunkTotals(static_cast<uint32_t>(chunking.ChunksCount()));
+
+		threadPool.ParallelFor(chunking.ChunksCount(), [&](uint64_t chunkIndex)
+		{
+			chunkTotals[chunkIndex] = ChunkTotal(chunkIndex);
+		});
+
+		for (uint32_t chunkIndex = 1u; chunkIndex != chunkTotals.size(); ++chunkIndex)
+		{
+			chunkTotals[chunkIndex] = scanFunction(chunkTotals[chunkIndex - 1u], chunkTotals[chunkIndex]);
+		}
+
+		threadPool.ParallelFor(chunking.ChunksCount(), [&](uint64_t chunkIndex)
+		{
+			ScanChunk(chunkIndex, chunkIndex ? &chunkTotals[chunkIndex - 1u] : nullptr);
+		});
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, typename SizeType>
+	inline void ParallelPrefixSum(const FixedArrayBase<DataType, SizeType>& input, FixedArrayBase<DataType, SizeType>& output, ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		assert(input.size() == output.size());
+
+		ParallelPrefixSum(input.data(), output.data(), input.size(), std::plus<DataType>(), threadPool);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// ParallelSort - chunks are sorted in parallel, then merged pairwise in rounds through a buffer
+	/// of the same length. Not stable.
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, typename CompareFunctionType = std::less<DataType> >
+	inline void ParallelSort(DataType* data, uint64_t elementsCount, CompareFunctionType compareFunction = CompareFunctionType(), ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		if (ParallelChunking::IsSerial(elementsCount, threadPool))
+		{
+			std::sort(data, data + elementsCount, compareFunction);
+			return;
+		}
+
+		const ParallelChunking chunking(elementsCount);
+
+		threadPool.ParallelFor(chunking.ChunksCount(), [&](uint64_t chunkIndex)
+		{
+			std::sort(data + chunking.ChunkStart(chunkIndex), data + chunking.ChunkEnd(chunkIndex), compareFunction);
+		});
+
+		LargeFixedArray<DataType> buffer(elementsCount);
+		DataType* source = data;
+		DataType* destination = buffer.data();
+
+		for (uint64_t runChunks = 1u; runChunks < chunking.ChunksCount(); runChunks *= 2u)
+		{
+			const uint64_t pairsCount = (chunking.ChunksCount() + runChunks * 2u - 1u) / (runChunks * 2u);
+
+			threadPool.ParallelFor(pairsCount, [&](uint64_t pairIndex)
+			{
+				const uint64_t leftStart = chunking.ChunkStart(pairIndex * runChunks * 2u);
+				const uint64_t middle = std::min(elementsCount, chunking.ChunkStart(pairIndex * runChunks * 2u + runChunks));
+				const uint64_t rightEnd = std::min(elementsCount, chunking.ChunkStart((pairIndex + 1u) * runChunks * 2u));
+
+				std::merge(std::make_move_iterator(source + leftStart), std::make_move_iterator(source + middle),
+					std::make_move_iterator(source + middle), std::make_move_iterator(source + rightEnd), destination + leftStart, compareFunction);
+			});
+
+			std::swap(source, destination);
+		}
+
+		if (source != data)
+		{
+			threadPool.ParallelFor(chunking.ChunksCount(), [&](uint64_t chunkIndex)
+			{
+				std::move(source + chunking.ChunkStart(chunkIndex), source + chunking.ChunkEnd(chunkIndex), data + chunking.ChunkStart(chunkIndex));
+			});
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, typename SizeType, typename CompareFunctionType = std::less<DataType> >
+	inline void ParallelSort(FixedArrayBase<DataType, SizeType>& array, CompareFunctionType compareFunction = CompareFunctionType(), ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		ParallelSort(array.data(), array.size(), compareFunction, threadPool);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// ParallelConvertSamples - samples_converter over chunks of about ParallelSamplesChunkBytes of
+	/// input and output together, which stay in L2 cache. Chunks are whole multiples of 64 samples, so
+	/// the vector kernels only run their scalar tail at the end of the buffer, and chunks are counted
+	/// in samples, so int24_t samples are never split. The result equals the serial conversion.
+	//-------------------------------------------------------------------------------------------------
+	template <typename input_t, typename output_t>
+	inline void ParallelConvertSamples(const void* inputBuffer, output_t* outputBuffer, uint64_t samplesCount, ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		if (ParallelChunking::IsSerial(samplesCount, threadPool))
+		{
+			samples_converter<input_t, output_t>::convert(inputBuffer, outputBuffer, samplesCount);
+			return;
+		}
+
+		const input_t* input = reinterpret_cast<const input_t*>(inputBuffer);
+		const ParallelChunking chunking(samplesCount, ParallelSamplesChunkBytes / (sizeof(input_t) + sizeof(output_t)));
+
+		threadPool.ParallelFor(chunking.ChunksCount(), [&](uint64_t chunkIndex)
+		{
+			const uint64_t chunkStart = chunking.ChunkStart(chunkIndex);
+
+			samples_converter<input_t, output_t>::convert(input + chunkStart, outputBuffer + chunkStart, chunking.ChunkEnd(chunkIndex) - chunkStart);
+		});
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename input_t, typename output_t, typename SizeType>
+	inline void ParallelConvertSamples(const FixedArrayBase<input_t, SizeType>& input, FixedArrayBase<output_t, SizeType>& output, ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		assert(input.size() == output.size());
+
+		ParallelConvertSamples<input_t, output_t>(input.data(), output.data(), input.size(), threadPool);
+	}
+}
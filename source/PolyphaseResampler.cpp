@@ -0,0 +1,190 @@
+#include "platform.h"
+#include "PolyphaseResampler.h"
+#include "CpuDispatch.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	static uint32_t GreatestCommonDivisor(uint32_t first, uint32_t second)
+	{
+		while (second != 0u)
+		{
+			const uint32_t remainder = first % second;
+
+			first = second;
+			second = remainder;
+		}
+
+		return first;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// Modified Bessel function of the first kind and order zero, for the Kaiser window.
+	static double BesselI0(double value)
+	{
+		const double quarterSquare = value * value * 0.25;
+		double term = 1.0;
+		double sum = 1.0;
+
+		for (uint32_t termIndex = 1u; term > sum * 1e-12; ++termIndex)
+		{
+			term *= quarterSquare / (static_cast<double>(termIndex) * termIndex);
+			sum += term;
+		}
+
+		return sum;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	PolyphaseResampler::PolyphaseResampler(uint32_t inputRate, uint32_t outputRate, uint32_t channelsCount, uint32_t tapsPerPhase) :
+		m_tapsCount((std::max(tapsPerPhase, 1u) + 7u) & ~7u),
+		m_channelsCount(channelsCount)
+	{
+		assert(inputRate != 0u && outputRate != 0u && channelsCount != 0u);
+
+		const uint32_t divisor = GreatestCommonDivisor(inputRate, outputRate);
+
+		m_interpolation = outputRate / divisor;
+		m_decimation = inputRate / divisor;
+
+		DesignFilter();
+
+		m_histories.reserve(channelsCount);
+
+		for (uint32_t channelIndex = 0u; channelIndex != channelsCount; ++channelIndex)
+		{
+			m_histories.emplace_back(m_tapsCount - 1u + BlockLength);
+		}
+
+		Reset();
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	void PolyphaseResampler::Reset()
+	{
+		for (auto& history : m_histories)
+		{
+			std::fill(history.data(), history.data() + m_tapsCount - 1u, 0.0f);
+		}
+
+		m_inputIndex = m_tapsCount - 1u;
+		m_phase = 0u;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// Lowpass at the upsampled rate with the cutoff a bit below the lower Nyquist frequency, the DC
+	/// gain of every phase is close to 1.
+	void PolyphaseResampler::DesignFilter()
+	{
+		const uint32_t length = m_interpolation * m_tapsCount;
+		const double cutoff = 0.5 * 0.95 / std::max(m_interpolation, m_decimation);
+		const double beta = 8.0;
+		const double center = (length - 1u) * 0.5;
+		const double windowNormalization = 1.0 / BesselI0(beta);
+		std::vector<double> prototype(length);
+		double sum = 0.0;
+
+		for (uint32_t tapIndex = 0u; tapIndex != length; ++tapIndex)
+		{
+			const double offset = tapIndex - center;
+			const double sinc = offset == 0.0 ? 2.0 * cutoff : sin(2.0 * M_PI * cutoff * offset) / (M_PI * offset);
+			const double windowPosition = length > 1u ? offset / center : 0.0;
+
+			prototype[tapIndex] = sinc * BesselI0(beta * sqrt(std::max(0.0, 1.0 - windowPosition * windowPosition))) * windowNormalization;
+			sum += prototype[tapIndex];
+		}
+
+		const double gain = m_interpolation / sum;
+
+		m_coefficients.Allocate(length);
+
+		// Output at upsampled time i * L + p is the sum of h[p + k * L] * x[i - k], reversing k makes
+		// the input window ascend
+		for (uint32_t phase = 0u; phase != m_interpolation; ++phase)
+		{
+			float* phaseCoefficients = m_coefficients.data() + phase * m_tapsCount;
+
+			for (uint32_t tapIndex = 0u; tapIndex != m_tapsCount; ++tapIndex)
+			{
+				phaseCoefficients[tapIndex] = static_cast<float>(prototype[phase + (m_tapsCount - 1u - tapIndex) * m_interpolation] * gain);
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	uint64_t PolyphaseResampler::Process(const float* const* input, uint64_t inputFrames, float* const* output)
+	{
+		const FilterKernel filter = CpuDispatch::Level() >= IsaLevel::Avx ? &FilterAvx : &FilterSse41;
+		const uint32_t historyLength = m_tapsCount - 1u;
+		uint64_t outputFrames = 0u;
+
+		for (uint64_t blockStart = 0u; blockStart < inputFrames; blockStart += BlockLength)
+		{
+			const uint64_t blockLength = std::min<uint64_t>(BlockLength, inputFrames - blockStart);
+			uint64_t inputIndex = m_inputIndex;
+			uint32_t phase = m_phase;
+			uint64_t blockOutputFrames = 0u;
+
+			// Every channel takes the same path through the block
+			for (uint32_t channelIndex = 0u; channelIndex != m_channelsCount; ++channelIndex)
+			{
+				float* history = m_histories[channelIndex].data();
+
+				memcpy(history + historyLength, input[channelIndex] + blockStart, blockLength * sizeof(float));
+
+				inputIndex = m_inputIndex;
+				phase = m_phase;
+				blockOutputFrames = filter(*this, history, historyLength + blockLength, inputIndex, phase, output[channelIndex] + outputFrames);
+
+				memmove(history, history + blockLength, historyLength * sizeof(float));
+			}
+
+			m_inputIndex = inputIndex - blockLength;
+			m_phase = phase;
+			outputFrames += blockOutputFrames;
+		}
+
+		return outputFrames;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	uint64_t PolyphaseResampler::FilterSse41(const PolyphaseResampler& resampler, const float* input, uint64_t inputLength, uint64_t& inputIndex, uint32_t& phase, float* output)
+	{
+		const uint32_t tapsCount = resampler.m_tapsCount;
+		const uint32_t interpolation = resampler.m_interpolation;
+		const uint32_t phaseStep = resampler.m_decimation % interpolation;
+		const uint32_t indexStep = resampler.m_decimation / interpolation;
+		uint64_t outputFrames = 0u;
+
+		for (; inputIndex < inputLength; ++outputFrames)
+		{
+			const float* coefficients = resampler.m_coefficients.data() + phase * tapsCount;
+			const float* window = input + inputIndex + 1u - tapsCount;
+			__m128 first = _mm_setzero_ps();
+			__m128 second = _mm_setzero_ps();
+
+			for (uint32_t tapIndex = 0u; tapIndex != tapsCount; tapIndex += 8u)
+			{
+				first = _mm_add_ps(first, _mm_mul_ps(_mm_load_ps(coefficients + tapIndex), _mm_loadu_ps(window + tapIndex)));
+				second = _mm_add_ps(second, _mm_mul_ps(_mm_load_ps(coefficients + tapIndex + 4u), _mm_loadu_ps(window + tapIndex + 4u)));
+			}
+
+			const __m128 sum = _mm_add_ps(first, second);
+			const __m128 pairs = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+
+			output[outputFrames] = _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 0x55)));
+
+			phase += phaseStep;
+			inputIndex += indexStep;
+
+			if (phase >= interpolation)
+			{
+				phase -= interpolation;
+				++inputIndex;
+			}
+		}
+
+		return outputFrames;
+	}
+}
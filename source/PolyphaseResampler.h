@@ -0,0 +1,86 @@
+#pragma once
+
+#include "FixedArray.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// PolyphaseResampler
+	///
+	/// Sample rate converter for planar float channels by the rational ratio outputRate / inputRate,
+	/// reduced to Interpolation() / Decimation(). The Kaiser windowed sinc lowpass is split into
+	/// Interpolation() phases of TapsPerPhase() coefficients each, stored reversed and padded to a
+	/// multiple of 8, so every output sample is one contiguous dot product. The dot products run with
+	/// AVX or SSE through CpuDispatch, the summation order differs between the levels.
+	///
+	/// Process may be called with blocks of any size, the filter history of every channel and the
+	/// position between input samples carry over to the next call. The output is delayed by
+	/// LatencyFrames() output frames.
+	//-------------------------------------------------------------------------------------------------
+	class PolyphaseResampler : public boost::noncopyable
+	{
+	private:
+		static constexpr uint32_t	BlockLength = 4096u;
+
+		typedef uint64_t (*FilterKernel)(const PolyphaseResampler& resampler, const float* input, uint64_t inputLength, uint64_t& inputIndex, uint32_t& phase, float* output);
+
+	private:
+		uint32_t					m_interpolation;
+		uint32_t					m_decimation;
+		uint32_t					m_tapsCount;
+		uint32_t					m_channelsCount;
+		FixedArray<float>			m_coefficients;					///< phase after phase, each reversed
+		std::vector<FixedArray<float>>	m_histories;				///< last taps - 1 samples, then a block
+		uint64_t					m_inputIndex;					///< newest sample of the next output in the history
+		uint32_t					m_phase;
+
+	public:
+		/// tapsPerPhase is rounded up to a multiple of 8, more taps give a steeper filter.
+		PolyphaseResampler(uint32_t inputRate, uint32_t outputRate, uint32_t channelsCount, uint32_t tapsPerPhase = 32u);
+
+		/// Resamples inputFrames frames of every channel, output must hold MaxOutputFrames(inputFrames).
+		/// Returns the number of output frames produced.
+		uint64_t Process(const float* const* input, uint64_t inputFrames, float* const* output);
+
+		/// Forgets the history, as if newly constructed.
+		void Reset();
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline uint64_t MaxOutputFrames(uint64_t inputFrames) const
+		{
+			return inputFrames * m_interpolation / m_decimation + 1u;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint64_t LatencyFrames() const
+		{
+			return (static_cast<uint64_t>(m_interpolation) * m_tapsCount - 1u) / (2u * m_decimation);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint32_t Interpolation() const
+		{
+			return m_interpolation;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint32_t Decimation() const
+		{
+			return m_decimation;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint32_t TapsPerPhase() const
+		{
+			return m_tapsCount;
+		}
+
+	private:
+		void DesignFilter();
+
+		static uint64_t FilterSse41(const PolyphaseResampler& resampler, const float* input, uint64_t inputLength, uint64_t& inputIndex, uint32_t& phase, float* output);
+		static uint64_t FilterAvx(const PolyphaseResampler& resampler, const float* input, uint64_t inputLength, uint64_t& inputIndex, uint32_t& phase, float* output);
+	};
+}
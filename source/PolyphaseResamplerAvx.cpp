@@ -0,0 +1,47 @@
+#include "platform.h"
+#include "PolyphaseResampler.h"
+
+#pragma GCC target("avx")
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	uint64_t PolyphaseResampler::FilterAvx(const PolyphaseResampler& resampler, const float* input, uint64_t inputLength, uint64_t& inputIndex, uint32_t& phase, float* output)
+	{
+		const uint32_t tapsCount = resampler.m_tapsCount;
+		const uint32_t interpolation = resampler.m_interpolation;
+		const uint32_t phaseStep = resampler.m_decimation % interpolation;
+		const uint32_t indexStep = resampler.m_decimation / interpolation;
+		const float* coefficientsStart = resampler.m_coefficients.data();
+		uint64_t outputFrames = 0u;
+
+		for (; inputIndex < inputLength; ++outputFrames)
+		{
+			const float* coefficients = coefficientsStart + phase * tapsCount;
+			const float* window = input + inputIndex + 1u - tapsCount;
+			__m256 sum = _mm256_mul_ps(_mm256_load_ps(coefficients), _mm256_loadu_ps(window));
+
+			for (uint32_t tapIndex = 8u; tapIndex != tapsCount; tapIndex += 8u)
+			{
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_load_ps(coefficients + tapIndex), _mm256_loadu_ps(window + tapIndex)));
+			}
+
+			const __m128 quad = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+			const __m128 pairs = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+
+			output[outputFrames] = _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 0x55)));
+
+			phase += phaseStep;
+			inputIndex += indexStep;
+
+			if (phase >= interpolation)
+			{
+				phase -= interpolation;
+				++inputIndex;
+			}
+		}
+
+		return outputFrames;
+	}
+}
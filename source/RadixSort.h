@@ -0,0 +1,338 @@
+#pragma once
+
+#include "FixedArray.h"
+#include "ParallelAlgorithms.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// RadixKey - maps keys onto unsigned integers of the same order
+	///
+	/// Signed integers get the sign bit flipped. Floating point keys get the sign bit set when
+	/// positive and all bits inverted when negative, so -NaN < -inf < ... < -0 < +0 < ... < inf < NaN.
+	//-------------------------------------------------------------------------------------------------
+	template <typename KeyType, typename EnableType = void>
+	class RadixKey;
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename KeyType>
+	class RadixKey<KeyType, typename std::enable_if<std::is_integral<KeyType>::value && !std::is_same<KeyType, bool>::value>::type>
+	{
+	public:
+		typedef typename std::make_unsigned<KeyType>::type		BitsType;
+
+		static constexpr BitsType	SignMask = std::is_signed<KeyType>::value ? BitsType(1u) << (sizeof(KeyType) * 8u - 1u) : BitsType(0u);
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		forceinline static BitsType ToBits(KeyType key)
+		{
+			return static_cast<BitsType>(key) ^ SignMask;
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename KeyType>
+	class RadixKey<KeyType, typename std::enable_if<std::is_floating_point<KeyType>::value>::type>
+	{
+		static_assert(sizeof(KeyType) == sizeof(uint32_t) || sizeof(KeyType) == sizeof(uint64_t), "Only float and double keys are supported.");
+
+	public:
+		typedef typename std::conditional<sizeof(KeyType) == sizeof(uint32_t), uint32_t, uint64_t>::type	BitsType;
+
+		static constexpr uint32_t	SignShift = sizeof(KeyType) * 8u - 1u;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		forceinline static BitsType ToBits(KeyType key)
+		{
+			BitsType bits;
+			memcpy(&bits, &key, sizeof(bits));
+
+			return bits ^ (static_cast<BitsType>(-static_cast<std::make_signed_t<BitsType>>(bits >> SignShift)) | (BitsType(1u) << SignShift));
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// 11 bit digits take 3 passes over 32 bit keys and 6 over 64 bit ones, while their histogram still
+	/// fits into L1 cache. Narrower keys use bytes.
+	//-------------------------------------------------------------------------------------------------
+	template <typename KeyType>
+	class RadixSortDefaultDigitBits : public std::integral_constant<uint32_t, sizeof(KeyType) >= sizeof(uint32_t) ? 11u : 8u>
+	{
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// RadixSorter
+	///
+	/// Stable least significant digit first radix sort of integral and floating point keys, optionally
+	/// carrying a payload array along. One pass over the keys builds the histograms of all digits,
+	/// digits having the same value in every key are skipped, the others scatter the elements between
+	/// the input and a scratch buffer of the same length. The histogram pass is split across the pool
+	/// threads when a pool is given. Inputs shorter than MinLength are sorted by comparison.
+	//-------------------------------------------------------------------------------------------------
+	template <typename KeyType, uint32_t DigitBits = RadixSortDefaultDigitBits<KeyType>::value>
+	class RadixSorter
+	{
+		static_assert(DigitBits == 8u || DigitBits == 11u, "Digits must be 8 or 11 bits wide.");
+
+	public:
+		typedef RadixKey<KeyType>					KeyTraits;
+		typedef typename KeyTraits::BitsType		BitsType;
+
+		static constexpr uint32_t	BucketsCount = 1u << DigitBits;
+		static constexpr uint32_t	DigitsCount = (sizeof(KeyType) * 8u + DigitBits - 1u) / DigitBits;
+		static constexpr uint64_t	MinLength = 128u;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		static void Sort(KeyType* keys, uint64_t elementsCount, ThreadPool* threadPool = nullptr)
+		{
+			if (elementsCount < MinLength)
+			{
+				std::sort(keys, keys + elementsCount, [](KeyType left, KeyType right) { return KeyTraits::ToBits(left) < KeyTraits::ToBits(right); });
+				return;
+			}
+
+			FixedArray<uint64_t> histograms;
+			BuildHistograms(keys, elementsCount, histograms, threadPool);
+
+			LargeFixedArray<KeyType> keysBuffer;
+			KeyType* sourceKeys = keys;
+			KeyType* destinationKeys = nullptr;
+
+			for (uint32_t digitIndex = 0u; digitIndex != DigitsCount; ++digitIndex)
+			{
+				uint64_t* offsets = histograms.data() + digitIndex * BucketsCount;
+				const uint32_t shift = digitIndex * DigitBits;
+
+				if (!PrepareOffsets(offsets, elementsCount, Digit(*sourceKeys, shift)))
+				{
+					continue;
+				}
+
+				if (destinationKeys == nullptr)
+				{
+					keysBuffer.Allocate(elementsCount);
+					destinationKeys = keysBuffer.data();
+				}
+
+				for (uint64_t elementIndex = 0u; elementIndex != elementsCount; ++elementIndex)
+				{
+					const KeyType key = sourceKeys[elementIndex];
+					destinationKeys[offsets[Digit(key, shift)]++] = key;
+				}
+
+				std::swap(sourceKeys, destinationKeys);
+			}
+
+			if (sourceKeys != keys)
+			{
+				memcpy(keys, sourceKeys, sizeof(KeyType) * elementsCount);
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// values[i] travels with keys[i], equal keys keep their order.
+		template <typename ValueType>
+		static void Sort(KeyType* keys, ValueType* values, uint64_t elementsCount, ThreadPool* threadPool = nullptr)
+		{
+			if (elementsCount < MinLength)
+			{
+				InsertionSort(keys, values, elementsCount);
+				return;
+			}
+
+			FixedArray<uint64_t> histograms;
+			BuildHistograms(keys, elementsCount, histograms, threadPool);
+
+			LargeFixedArray<KeyType> keysBuffer;
+			LargeFixedArray<ValueType> valuesBuffer;
+			KeyType* sourceKeys = keys;
+			KeyType* destinationKeys = nullptr;
+			ValueType* sourceValues = values;
+			ValueType* destinationValues = nullptr;
+
+			for (uint32_t digitIndex = 0u; digitIndex != DigitsCount; ++digitIndex)
+			{
+				uint64_t* offsets = histograms.data() + digitIndex * BucketsCount;
+				const uint32_t shift = digitIndex * DigitBits;
+
+				if (!PrepareOffsets(offsets, elementsCount, Digit(*sourceKeys, shift)))
+				{
+					continue;
+				}
+
+				if (destinationKeys == nullptr)
+				{
+					keysBuffer.Allocate(elementsCount);
+					valuesBuffer.Allocate(elementsCount);
+					destinationKeys = keysBuffer.data();
+					destinationValues = valuesBuffer.data();
+				}
+
+				for (uint64_t elementIndex = 0u; elementIndex != elementsCount; ++elementIndex)
+				{
+					const KeyType key = sourceKeys[elementIndex];
+					const uint64_t destinationIndex = offsets[Digit(key, shift)]++;
+
+					destinationKeys[destinationIndex] = key;
+					destinationValues[destinationIndex] = std::move(sourceValues[elementIndex]);
+				}
+
+				std::swap(sourceKeys, destinationKeys);
+				std::swap(sourceValues, destinationValues);
+			}
+
+			if (sourceKeys != keys)
+			{
+				memcpy(keys, sourceKeys, sizeof(KeyType) * elementsCount);
+				std::move(sourceValues, sourceValues + elementsCount, values);
+			}
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		forceinline static uint32_t Digit(KeyType key, uint32_t shift)
+		{
+			return static_cast<uint32_t>(KeyTraits::ToBits(key) >> shift) & (BucketsCount - 1u);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Digit counts of keys, DigitsCount histograms of BucketsCount entries one after another.
+		static void CountDigits(const KeyType* keys, uint64_t elementsCount, uint64_t* histograms)
+		{
+			for (uint64_t elementIndex = 0u; elementIndex != elementsCount; ++elementIndex)
+			{
+				const BitsType bits = KeyTraits::ToBits(keys[elementIndex]);
+
+				for (uint32_t digitIndex = 0u; digitIndex != DigitsCount; ++digitIndex)
+				{
+					++histograms[digitIndex * BucketsCount + (static_cast<uint32_t>(bits >> (digitIndex * DigitBits)) & (BucketsCount - 1u))];
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static void BuildHistograms(const KeyType* keys, uint64_t elementsCount, FixedArray<uint64_t>& histograms, ThreadPool* threadPool)
+		{
+			const uint32_t histogramsLength = DigitsCount * BucketsCount;
+
+			histograms.Resize(histogramsLength, 0u);
+
+			if (threadPool == nullptr || ParallelChunking::IsSerial(elementsCount, *threadPool))
+			{
+				CountDigits(keys, elementsCount, histograms.data());
+				return;
+			}
+
+			// One slice per thread, every slice counts into its own histograms
+			const uint32_t slicesCount = threadPool->ThreadsCount();
+			FixedArray<uint64_t> sliceHistograms(slicesCount * histogramsLength, 0u);
+
+			threadPool->ParallelFor(slicesCount, [&](uint64_t sliceIndex)
+			{
+				const uint64_t sliceStart = elementsCount * sliceIndex / slicesCount;
+				const uint64_t sliceEnd = elementsCount * (sliceIndex + 1u) / slicesCount;
+
+				CountDigits(keys + sliceStart, sliceEnd - sliceStart, sliceHistograms.data() + sliceIndex * histogramsLength);
+			});
+
+			for (uint32_t sliceIndex = 0u; sliceIndex != slicesCount; ++sliceIndex)
+			{
+				const uint64_t* sliceHistogram = sliceHistograms.data() + sliceIndex * histogramsLength;
+
+				for (uint32_t entryIndex = 0u; entryIndex != histogramsLength; ++entryIndex)
+				{
+					histograms[entryIndex] += sliceHistogram[entryIndex];
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Turns counts into the starting offsets of buckets. Returns false when every key falls into
+		/// the bucket of anyDigit, so the pass would not move anything.
+		static bool PrepareOffsets(uint64_t* offsets, uint64_t elementsCount, uint32_t anyDigit)
+		{
+			if (offsets[anyDigit] == elementsCount)
+			{
+				return false;
+			}
+
+			uint64_t offset = 0u;
+
+			for (uint32_t bucketIndex = 0u; bucketIndex != BucketsCount; ++bucketIndex)
+			{
+				const uint64_t bucketCount = offsets[bucketIndex];
+
+				offsets[bucketIndex] = offset;
+				offset += bucketCount;
+			}
+
+			return true;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename ValueType>
+		static void InsertionSort(KeyType* keys, ValueType* values, uint64_t elementsCount)
+		{
+			for (uint64_t elementIndex = 1u; elementIndex < elementsCount; ++elementIndex)
+			{
+				const KeyType key = keys[elementIndex];
+				const BitsType keyBits = KeyTraits::ToBits(key);
+
+				if (!(keyBits < KeyTraits::ToBits(keys[elementIndex - 1u])))
+				{
+					continue;
+				}
+
+				ValueType value(std::move(values[elementIndex]));
+				uint64_t insertIndex = elementIndex;
+
+				do
+				{
+					keys[insertIndex] = keys[insertIndex - 1u];
+					values[insertIndex] = std::move(values[insertIndex - 1u]);
+					--insertIndex;
+				}
+				while (insertIndex && keyBits < KeyTraits::ToBits(keys[insertIndex - 1u]));
+
+				keys[insertIndex] = key;
+				values[insertIndex] = std::move(value);
+			}
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// RadixSort - RadixSorter with the default digit width, use RadixSorter<KeyType, 8> to override
+	//-------------------------------------------------------------------------------------------------
+	template <typename KeyType>
+	inline void RadixSort(KeyType* keys, uint64_t elementsCount, ThreadPool* threadPool = nullptr)
+	{
+		RadixSorter<KeyType>::Sort(keys, elementsCount, threadPool);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename KeyType, typename ValueType>
+	inline void RadixSort(KeyType* keys, ValueType* values, uint64_t elementsCount, ThreadPool* threadPool = nullptr)
+	{
+		RadixSorter<KeyType>::Sort(keys, values, elementsCount, threadPool);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename KeyType, typename SizeType>
+	inline void RadixSort(FixedArrayBase<KeyType, SizeType>& keys, ThreadPool* threadPool = nullptr)
+	{
+		RadixSorter<KeyType>::Sort(keys.data(), keys.size(), threadPool);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	template <typename KeyType, typename ValueType, typename SizeType>
+	inline void RadixSort(FixedArrayBase<KeyType, SizeType>& keys, FixedArrayBase<ValueType, SizeType>& values, ThreadPool* threadPool = nullptr)
+	{
+		assert(keys.size() == values.size());
+
+		RadixSorter<KeyType>::Sort(keys.data(), values.data(), keys.size(), threadPool);
+	}
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "IStream.h"
+#include "Miscellaneous.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// SampleConvertingStream
+	///
+	/// Decorator showing a stream of input_t samples as a stream of output_t samples: Read converts
+	/// input_t into output_t, Write converts output_t back into input_t. Samples go through a staging
+	/// buffer of StagingLength bytes on the stack, so a conversion of any size runs in constant
+	/// memory. Reads and writes may stop inside a sample on either side: an incomplete input_t sample
+	/// from the source waits for its remaining bytes, the rest of a converted sample waits for the
+	/// next Read, and an incomplete written sample waits for the next Write. Read and Seek drop an
+	/// incomplete written sample. Positions and lengths are in output_t bytes.
+	//-------------------------------------------------------------------------------------------------
+	template <typename input_t, typename output_t>
+	class SampleConvertingStream : public IStream, public boost::noncopyable
+	{
+	private:
+		static constexpr uint32_t	StagingLength = 4096u;
+		static constexpr uint32_t	StagingSamplesCount = StagingLength / std::max(sizeof(input_t), sizeof(output_t));
+
+	private:
+		IStream&					m_source;
+		alignas(output_t) byte		m_readTail[sizeof(output_t)];
+		uint32_t					m_readTailOffset;
+		alignas(input_t) byte		m_inputCarry[sizeof(input_t)];
+		uint32_t					m_inputCarryLength;
+		alignas(output_t) byte		m_writeCarry[sizeof(output_t)];
+		uint32_t					m_writeCarryLength;
+
+	public:
+		SampleConvertingStream(IStream& source) :
+			m_source(source),
+			m_readTailOffset(sizeof(output_t)),
+			m_inputCarryLength(0u),
+			m_writeCarryLength(0u)
+		{
+		}
+
+		virtual ~SampleConvertingStream()
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		virtual StreamPos Read(byte* outputBuffer, StreamPos bytesToRead) override final
+		{
+			if (m_writeCarryLength != 0u)
+			{
+				Seek(SeekOrigin::Begin, static_cast<StreamSeek>(Tell()));
+			}
+
+			StreamPos bytesRead = std::min<StreamPos>(sizeof(output_t) - m_readTailOffset, bytesToRead);
+
+			memcpy(outputBuffer, m_readTail + m_readTailOffset, bytesRead);
+			m_readTailOffset += static_cast<uint32_t>(bytesRead);
+
+			alignas(32) byte inputStaging[StagingSamplesCount * sizeof(input_t)];
+			alignas(32) byte outputStaging[StagingSamplesCount * sizeof(output_t)];
+
+			while (bytesRead != bytesToRead)
+			{
+				const StreamPos samplesWanted = std::min<StreamPos>((bytesToRead - bytesRead + sizeof(output_t) - 1u) / sizeof(output_t), StagingSamplesCount);
+
+				memcpy(inputStaging, m_inputCarry, m_inputCarryLength);
+
+				const StreamPos sourceBytes = m_source.Read(inputStaging + m_inputCarryLength, samplesWanted * sizeof(input_t) - m_inputCarryLength);
+
+				if (sourceBytes == 0u)
+				{
+					break;
+				}
+
+				const StreamPos stagedBytes = m_inputCarryLength + sourceBytes;
+				const StreamPos samplesCount = stagedBytes / sizeof(input_t);
+
+				m_inputCarryLength = static_cast<uint32_t>(stagedBytes % sizeof(input_t));
+				memcpy(m_inputCarry, inputStaging + samplesCount * sizeof(input_t), m_inputCarryLength);
+
+				if (samplesCount == 0u)
+				{
+					continue;
+				}
+
+				samples_converter<input_t, output_t>::convert(inputStaging, reinterpret_cast<output_t*>(outputStaging), samplesCount);
+
+				const StreamPos convertedBytes = samplesCount * sizeof(output_t);
+				const StreamPos takenBytes = std::min(convertedBytes, bytesToRead - bytesRead);
+
+				memcpy(outputBuffer + bytesRead, outputStaging, takenBytes);
+				bytesRead += takenBytes;
+
+				// samplesWanted rounds up, so only the last sample can be left partially
+				if (takenBytes != convertedBytes)
+				{
+					memcpy(m_readTail, outputStaging + convertedBytes - sizeof(output_t), sizeof(output_t));
+					m_readTailOffset = static_cast<uint32_t>(sizeof(output_t) - (convertedBytes - takenBytes));
+				}
+			}
+
+			return bytesRead;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		virtual StreamPos Write(const void* inputBuffer, StreamPos bytesToWrite) override final
+		{
+			RewindReading();
+
+			const byte* input = reinterpret_cast<const byte*>(inputBuffer);
+			StreamPos bytesTaken = 0u;
+			alignas(32) byte inputStaging[StagingSamplesCount * sizeof(output_t)];
+			alignas(32) byte staging[StagingSamplesCount * sizeof(input_t)];
+
+			if (m_writeCarryLength != 0u)
+			{
+				bytesTaken = std::min<StreamPos>(sizeof(output_t) - m_writeCarryLength, bytesToWrite);
+
+				memcpy(m_writeCarry + m_writeCarryLength, input, bytesTaken);
+				m_writeCarryLength += static_cast<uint32_t>(bytesTaken);
+
+				if (m_writeCarryLength != sizeof(output_t))
+				{
+					return bytesTaken;
+				}
+
+				samples_converter<output_t, input_t>::convert(m_writeCarry, reinterpret_cast<input_t*>(staging), 1u);
+				m_writeCarryLength = 0u;
+
+				if (m_source.Write(staging, sizeof(input_t)) != sizeof(input_t))
+				{
+					return 0u;
+				}
+			}
+
+			while (bytesToWrite - bytesTaken >= sizeof(output_t))
+			{
+				const StreamPos samplesCount = std::min<StreamPos>((bytesToWrite - bytesTaken) / sizeof(output_t), StagingSamplesCount);
+				const StreamPos stagedBytes = samplesCount * sizeof(input_t);
+
+				// The caller's buffer may be misaligned after an incomplete sample
+				memcpy(inputStaging, input + bytesTaken, samplesCount * sizeof(output_t));
+				samples_converter<output_t, input_t>::convert(inputStaging, reinterpret_cast<input_t*>(staging), samplesCount);
+
+				const StreamPos writtenBytes = m_source.Write(staging, stagedBytes);
+
+				if (writtenBytes != stagedBytes)
+				{
+					return bytesTaken + writtenBytes / sizeof(input_t) * sizeof(output_t);
+				}
+
+				bytesTaken += samplesCount * sizeof(output_t);
+			}
+
+			m_writeCarryLength = static_cast<uint32_t>(bytesToWrite - bytesTaken);
+			memcpy(m_writeCarry, input + bytesTaken, m_writeCarryLength);
+
+			return bytesToWrite;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Seeking inside a sample reads and converts that sample.
+		virtual StreamPos Seek(SeekOrigin seekOrigin, StreamSeek bytesToSeek) override final
+		{
+			StreamSeek newPosition = bytesToSeek;
+
+			switch (seekOrigin)
+			{
+			case SeekOrigin::Begin:
+				break;
+
+			case SeekOrigin::Current:
+				newPosition += static_cast<StreamSeek>(Tell());
+				break;
+
+			case SeekOrigin::End:
+				newPosition += static_cast<StreamSeek>(Length());
+				break;
+			}
+
+			const StreamPos position = static_cast<StreamPos>(std::max<StreamSeek>(newPosition, 0));
+			const uint32_t sampleOffset = static_cast<uint32_t>(position % sizeof(output_t));
+
+			m_readTailOffset = sizeof(output_t);
+			m_inputCarryLength = 0u;
+			m_writeCarryLength = 0u;
+			m_source.Seek(SeekOrigin::Begin, static_cast<StreamSeek>(position / sizeof(output_t) * sizeof(input_t)));
+
+			if (sampleOffset != 0u)
+			{
+				StreamPos sourceBytes;
+
+				// The source may return the sample in parts, at its end an incomplete one stays carried
+				while (m_inputCarryLength != sizeof(input_t) && (sourceBytes = m_source.Read(m_inputCarry + m_inputCarryLength, sizeof(input_t) - m_inputCarryLength)) != 0u)
+				{
+					m_inputCarryLength += static_cast<uint32_t>(sourceBytes);
+				}
+
+				if (m_inputCarryLength == sizeof(input_t))
+				{
+					samples_converter<input_t, output_t>::convert(m_inputCarry, reinterpret_cast<output_t*>(m_readTail), 1u);
+					m_readTailOffset = sampleOffset;
+					m_inputCarryLength = 0u;
+				}
+			}
+
+			return Tell();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		virtual StreamPos SetLength(StreamPos requiredLength) override final
+		{
+			return m_source.SetLength(requiredLength / sizeof(output_t) * sizeof(input_t)) / sizeof(input_t) * sizeof(output_t);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		virtual StreamPos Tell() const override final
+		{
+			const StreamPos sourceSamples = (m_source.Tell() - m_inputCarryLength) / sizeof(input_t);
+
+			return sourceSamples * sizeof(output_t) - (sizeof(output_t) - m_readTailOffset) + m_writeCarryLength;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		virtual StreamPos Length() const override final
+		{
+			return std::max(m_source.Length() / sizeof(input_t) * sizeof(output_t), Tell());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		virtual bool Reserve(StreamPos requiredCapacity) override final
+		{
+			return m_source.Reserve((requiredCapacity + sizeof(output_t) - 1u) / sizeof(output_t) * sizeof(input_t));
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		/// Moves the source back to the first sample not read completely, a partially read sample
+		/// becomes the start of an incomplete written one.
+		void RewindReading()
+		{
+			const bool readTailPending = m_readTailOffset != sizeof(output_t);
+
+			if (!readTailPending && m_inputCarryLength == 0u)
+			{
+				return;
+			}
+
+			const StreamSeek rewindBytes = static_cast<StreamSeek>(m_inputCarryLength + (readTailPending ? sizeof(input_t) : 0u));
+
+			m_source.Seek(SeekOrigin::Current, -rewindBytes);
+
+			if (readTailPending)
+			{
+				memcpy(m_writeCarry, m_readTail, m_readTailOffset);
+				m_writeCarryLength = m_readTailOffset;
+			}
+
+			m_readTailOffset = sizeof(output_t);
+			m_inputCarryLength = 0u;
+		}
+	};
+}
@@ -0,0 +1,298 @@
+#pragma once
+
+#include "Miscellaneous.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// samples_planes - moves samples between interleaved frames and channel planes
+	///
+	/// Stereo, 5.1 and 7.1 get loops with the channels count fixed at compile time, stereo samples of
+	/// 4 bytes are shuffled with SSE. Planes are addressed from planeOffset on.
+	//-------------------------------------------------------------------------------------------------
+	template <typename sample_t>
+	class samples_planes
+	{
+	public:
+		//---------------------------------------------------------------------------------------------
+		static void deinterleave(const sample_t* input, sample_t* const* planes, uint64_t planeOffset, uint32_t channelsCount, uint64_t framesCount)
+		{
+			switch (channelsCount)
+			{
+			case 2u:
+				deinterleave_fixed<2u>(input, planes, planeOffset, framesCount);
+				break;
+
+			case 6u:
+				deinterleave_fixed<6u>(input, planes, planeOffset, framesCount);
+				break;
+
+			case 8u:
+				deinterleave_fixed<8u>(input, planes, planeOffset, framesCount);
+				break;
+
+			default:
+				for (uint32_t channelIndex = 0u; channelIndex != channelsCount; ++channelIndex)
+				{
+					sample_t* plane = planes[channelIndex] + planeOffset;
+
+					for (uint64_t frameIndex = 0u; frameIndex != framesCount; ++frameIndex)
+					{
+						plane[frameIndex] = input[frameIndex * channelsCount + channelIndex];
+					}
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static void interleave(const sample_t* const* planes, uint64_t planeOffset, sample_t* output, uint32_t channelsCount, uint64_t framesCount)
+		{
+			switch (channelsCount)
+			{
+			case 2u:
+				interleave_fixed<2u>(planes, planeOffset, output, framesCount);
+				break;
+
+			case 6u:
+				interleave_fixed<6u>(planes, planeOffset, output, framesCount);
+				break;
+
+			case 8u:
+				interleave_fixed<8u>(planes, planeOffset, output, framesCount);
+				break;
+
+			default:
+				for (uint32_t channelIndex = 0u; channelIndex != channelsCount; ++channelIndex)
+				{
+					const sample_t* plane = planes[channelIndex] + planeOffset;
+
+					for (uint64_t frameIndex = 0u; frameIndex != framesCount; ++frameIndex)
+					{
+						output[frameIndex * channelsCount + channelIndex] = plane[frameIndex];
+					}
+				}
+			}
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		template <uint32_t channels_count>
+		forceinline static void deinterleave_fixed(const sample_t* input, sample_t* const* planes, uint64_t planeOffset, uint64_t framesCount)
+		{
+			sample_t* channelPlanes[channels_count];
+
+			for (uint32_t channelIndex = 0u; channelIndex != channels_count; ++channelIndex)
+			{
+				channelPlanes[channelIndex] = planes[channelIndex] + planeOffset;
+			}
+
+			uint64_t frameIndex = 0u;
+
+			if (channels_count == 2u && sizeof(sample_t) == sizeof(float))
+			{
+				// [l0 r0 l1 r1] [l2 r2 l3 r3] -> [l0 l1 l2 l3] [r0 r1 r2 r3]
+				for (const uint64_t vectorFramesCount = framesCount & ~uint64_t(3u); frameIndex != vectorFramesCount; frameIndex += 4u)
+				{
+					const __m128 first = _mm_loadu_ps(reinterpret_cast<const float*>(input + frameIndex * 2u));
+					const __m128 second = _mm_loadu_ps(reinterpret_cast<const float*>(input + frameIndex * 2u + 4u));
+
+					_mm_storeu_ps(reinterpret_cast<float*>(channelPlanes[0] + frameIndex), _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+					_mm_storeu_ps(reinterpret_cast<float*>(channelPlanes[1] + frameIndex), _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+				}
+			}
+
+			for (; frameIndex != framesCount; ++frameIndex)
+			{
+				for (uint32_t channelIndex = 0u; channelIndex != channels_count; ++channelIndex)
+				{
+					channelPlanes[channelIndex][frameIndex] = input[frameIndex * channels_count + channelIndex];
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <uint32_t channels_count>
+		forceinline static void interleave_fixed(const sample_t* const* planes, uint64_t planeOffset, sample_t* output, uint64_t framesCount)
+		{
+			const sample_t* channelPlanes[channels_count];
+
+			for (uint32_t channelIndex = 0u; channelIndex != channels_count; ++channelIndex)
+			{
+				channelPlanes[channelIndex] = planes[channelIndex] + planeOffset;
+			}
+
+			uint64_t frameIndex = 0u;
+
+			if (channels_count == 2u && sizeof(sample_t) == sizeof(float))
+			{
+				for (const uint64_t vectorFramesCount = framesCount & ~uint64_t(3u); frameIndex != vectorFramesCount; frameIndex += 4u)
+				{
+					const __m128 left = _mm_loadu_ps(reinterpret_cast<const float*>(channelPlanes[0] + frameIndex));
+					const __m128 right = _mm_loadu_ps(reinterpret_cast<const float*>(channelPlanes[1] + frameIndex));
+
+					_mm_storeu_ps(reinterpret_cast<float*>(output + frameIndex * 2u), _mm_unpacklo_ps(left, right));
+					_mm_storeu_ps(reinterpret_cast<float*>(output + frameIndex * 2u + 4u), _mm_unpackhi_ps(left, right));
+				}
+			}
+
+			for (; frameIndex != framesCount; ++frameIndex)
+			{
+				for (uint32_t channelIndex = 0u; channelIndex != channels_count; ++channelIndex)
+				{
+					output[frameIndex * channels_count + channelIndex] = channelPlanes[channelIndex][frameIndex];
+				}
+			}
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// samples_layout_staging - block size of the fused converters
+	///
+	/// The fused converters go through the frames block by block, converting a block with
+	/// samples_converter into a staging buffer which stays in L1 cache and (de)interleaving it from
+	/// there. Main memory sees a single pass over the input and the output instead of two.
+	//-------------------------------------------------------------------------------------------------
+	class samples_layout_staging
+	{
+	public:
+		static constexpr uint32_t	length = 8192u;
+
+		//---------------------------------------------------------------------------------------------
+		/// Frames per block, whole groups of 8 samples for the vector kernels where possible. Zero
+		/// when a single frame does not fit, such frames go through the staging in channel slices.
+		template <typename staging_t>
+		static uint64_t block_frames(uint32_t channelsCount)
+		{
+			const uint64_t blockFrames = length / sizeof(staging_t) / channelsCount;
+
+			return blockFrames >= 8u ? blockFrames & ~uint64_t(7u) : blockFrames;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Channels of one wide frame per slice.
+		template <typename staging_t>
+		static uint32_t slice_channels()
+		{
+			return static_cast<uint32_t>(length / sizeof(staging_t));
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// samples_deinterleaver - converts interleaved frames into channel planes in one pass
+	//-------------------------------------------------------------------------------------------------
+	template <typename input_t, typename output_t>
+	class samples_deinterleaver
+	{
+	public:
+		//---------------------------------------------------------------------------------------------
+		static void convert(const void* inputBuffer, output_t* const* outputPlanes, uint32_t channelsCount, uint64_t framesCount)
+		{
+			const input_t* input = reinterpret_cast<const input_t*>(inputBuffer);
+
+			if (channelsCount == 1u)
+			{
+				samples_converter<input_t, output_t>::convert(input, outputPlanes[0], framesCount);
+				return;
+			}
+
+			if (std::is_same<input_t, output_t>::value)
+			{
+				samples_planes<output_t>::deinterleave(reinterpret_cast<const output_t*>(input), outputPlanes, 0u, channelsCount, framesCount);
+				return;
+			}
+
+			alignas(64) byte stagingBuffer[samples_layout_staging::length];
+			output_t* staging = reinterpret_cast<output_t*>(stagingBuffer);
+			const uint64_t blockFrames = samples_layout_staging::block_frames<output_t>(channelsCount);
+
+			if (blockFrames == 0u)
+			{
+				const uint32_t sliceChannels = samples_layout_staging::slice_channels<output_t>();
+
+				for (uint64_t frameIndex = 0u; frameIndex != framesCount; ++frameIndex)
+				{
+					for (uint32_t sliceStart = 0u; sliceStart < channelsCount; sliceStart += sliceChannels)
+					{
+						const uint32_t channelsInSlice = std::min(sliceChannels, channelsCount - sliceStart);
+
+						samples_converter<input_t, output_t>::convert(input + frameIndex * channelsCount + sliceStart, staging, channelsInSlice);
+
+						for (uint32_t channelIndex = 0u; channelIndex != channelsInSlice; ++channelIndex)
+						{
+							outputPlanes[sliceStart + channelIndex][frameIndex] = staging[channelIndex];
+						}
+					}
+				}
+
+				return;
+			}
+
+			for (uint64_t frameIndex = 0u; frameIndex < framesCount; frameIndex += blockFrames)
+			{
+				const uint64_t framesInBlock = std::min(blockFrames, framesCount - frameIndex);
+
+				samples_converter<input_t, output_t>::convert(input + frameIndex * channelsCount, staging, framesInBlock * channelsCount);
+				samples_planes<output_t>::deinterleave(staging, outputPlanes, frameIndex, channelsCount, framesInBlock);
+			}
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// samples_interleaver - converts channel planes into interleaved frames in one pass
+	//-------------------------------------------------------------------------------------------------
+	template <typename input_t, typename output_t>
+	class samples_interleaver
+	{
+	public:
+		//---------------------------------------------------------------------------------------------
+		static void convert(const input_t* const* inputPlanes, output_t* outputBuffer, uint32_t channelsCount, uint64_t framesCount)
+		{
+			if (channelsCount == 1u)
+			{
+				samples_converter<input_t, output_t>::convert(inputPlanes[0], outputBuffer, framesCount);
+				return;
+			}
+
+			if (std::is_same<input_t, output_t>::value)
+			{
+				samples_planes<input_t>::interleave(inputPlanes, 0u, reinterpret_cast<input_t*>(outputBuffer), channelsCount, framesCount);
+				return;
+			}
+
+			alignas(64) byte stagingBuffer[samples_layout_staging::length];
+			input_t* staging = reinterpret_cast<input_t*>(stagingBuffer);
+			const uint64_t blockFrames = samples_layout_staging::block_frames<input_t>(channelsCount);
+
+			if (blockFrames == 0u)
+			{
+				const uint32_t sliceChannels = samples_layout_staging::slice_channels<input_t>();
+
+				for (uint64_t frameIndex = 0u; frameIndex != framesCount; ++frameIndex)
+				{
+					for (uint32_t sliceStart = 0u; sliceStart < channelsCount; sliceStart += sliceChannels)
+					{
+						const uint32_t channelsInSlice = std::min(sliceChannels, channelsCount - sliceStart);
+
+						for (uint32_t channelIndex = 0u; channelIndex != channelsInSlice; ++channelIndex)
+						{
+							staging[channelIndex] = inputPlanes[sliceStart + channelIndex][frameIndex];
+						}
+
+						samples_converter<input_t, output_t>::convert(staging, outputBuffer + frameIndex * channelsCount + sliceStart, channelsInSlice);
+					}
+				}
+
+				return;
+			}
+
+			for (uint64_t frameIndex = 0u; frameIndex < framesCount; frameIndex += blockFrames)
+			{
+				const uint64_t framesInBlock = std::min(blockFrames, framesCount - frameIndex);
+
+				samples_planes<input_t>::interleave(inputPlanes, frameIndex, staging, channelsCount, framesInBlock);
+				samples_converter<input_t, output_t>::convert(staging, outputBuffer + frameIndex * channelsCount, framesInBlock * channelsCount);
+			}
+		}
+	};
+}
@@ -0,0 +1,47 @@
+#include "platform.h"
+#include "Miscellaneous.h"
+#include "SamplesKernels.h"
+
+
+namespace aux
+{
+	namespace
+	{
+		//---------------------------------------------------------------------------------------------
+		class Sse41SamplesOps : public sse_samples_ops<Sse41SamplesOps>
+		{
+		};
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	SamplesKernel SamplesKernels::Get(SampleType inputType, SampleType outputType)
+	{
+		return LevelTable(CpuDispatch::Level()).m_kernels[static_cast<uint32_t>(inputType)][static_cast<uint32_t>(outputType)];
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// Tables of the higher levels are built by code compiled for them, so they are touched only once
+	/// the level is known to be supported.
+	const SamplesKernels::Table& SamplesKernels::LevelTable(IsaLevel level)
+	{
+		switch (level)
+		{
+		case IsaLevel::Avx:
+			return AvxTable();
+
+		case IsaLevel::Avx2:
+			return Avx2Table();
+
+		default:
+			return Sse41Table();
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	const SamplesKernels::Table& SamplesKernels::Sse41Table()
+	{
+		static const Table table = samples_kernels<Sse41SamplesOps>::MakeTable();
+
+		return table;
+	}
+}
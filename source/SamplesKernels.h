@@ -0,0 +1,358 @@
+#pragma once
+
+#include "Miscellaneous.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// samples_kernels
+	///
+	/// Kernel loops shared by the ISA levels, ops_t supplies the 8 samples wide operations of one
+	/// level. SamplesKernels*.cpp include this header after their #pragma GCC target, so the loops are
+	/// compiled for that level. Everything here is a template of ops_t, which keeps the instances of
+	/// different levels apart. Non-template code must be included before the pragma, otherwise its
+	/// inline functions would be compiled for different levels in different files.
+	///
+	/// ops_t interface, int_vector holds 8 samples in int32 lanes:
+	///		load(const int16_t/int24_t/int32_t*)				sign extended samples
+	///		store(int16_t/int24_t/int32_t*, int_vector)		saturated samples
+	///		scale_up<shift>(int_vector)						<< shift, low bits filled by ~sign
+	///		scale_down<shift>(int_vector)					inverse of scale_up, >> shift rounded half up
+	///		store_float/store_double(output, int_vector, m)	lanes converted and multiplied by m
+	///		load_float<exact_maximum>/load_double(input, m)	input * m clamped and truncated
+	///		float_to_double/double_to_float(input, output)
+	//-------------------------------------------------------------------------------------------------
+	template <typename ops_t>
+	class samples_kernels
+	{
+	public:
+		//---------------------------------------------------------------------------------------------
+		static SamplesKernels::Table MakeTable()
+		{
+			SamplesKernels::Table table;
+
+			for (auto& outputKernels : table.m_kernels)
+			{
+				std::fill(std::begin(outputKernels), std::end(outputKernels), &convert_nothing);
+			}
+
+			Set<int16_t, int24_t>(table, &widen<int16_t, int24_t>);
+			Set<int16_t, int32_t>(table, &widen<int16_t, int32_t>);
+			Set<int24_t, int32_t>(table, &widen<int24_t, int32_t>);
+			Set<int24_t, int16_t>(table, &narrow<int24_t, int16_t>);
+			Set<int32_t, int16_t>(table, &narrow<int32_t, int16_t>);
+			Set<int32_t, int24_t>(table, &narrow<int32_t, int24_t>);
+			Set<int16_t, float>(table, &integer_to_float<int16_t>);
+			Set<int24_t, float>(table, &integer_to_float<int24_t>);
+			Set<int32_t, float>(table, &integer_to_float<int32_t>);
+			Set<int16_t, double>(table, &integer_to_double<int16_t>);
+			Set<int24_t, double>(table, &integer_to_double<int24_t>);
+			Set<int32_t, double>(table, &integer_to_double<int32_t>);
+			Set<float, int16_t>(table, &float_to_integer<int16_t>);
+			Set<float, int24_t>(table, &float_to_integer<int24_t>);
+			Set<float, int32_t>(table, &float_to_integer<int32_t>);
+			Set<double, int16_t>(table, &double_to_integer<int16_t>);
+			Set<double, int24_t>(table, &double_to_integer<int24_t>);
+			Set<double, int32_t>(table, &double_to_integer<int32_t>);
+			Set<float, double>(table, &float_to_double);
+			Set<double, float>(table, &double_to_float);
+
+			return table;
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		template <typename input_t, typename output_t>
+		static void Set(SamplesKernels::Table& table, SamplesKernel kernel)
+		{
+			table.m_kernels[static_cast<uint32_t>(sample_type<input_t>::value)][static_cast<uint32_t>(sample_type<output_t>::value)] = kernel;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static uint64_t convert_nothing(const void* inputBuffer, void* outputBuffer, uint64_t samplesCount)
+		{
+			return 0u;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename input_t, typename output_t>
+		static uint64_t widen(const void* inputBuffer, void* outputBuffer, uint64_t samplesCount)
+		{
+			const input_t* input = reinterpret_cast<const input_t*>(inputBuffer);
+			output_t* output = reinterpret_cast<output_t*>(outputBuffer);
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(7u);
+
+			for (uint64_t sampleIndex = 0u; sampleIndex != vectorSamplesCount; sampleIndex += 8u)
+			{
+				ops_t::store(output + sampleIndex, ops_t::template scale_up<sample_lanes<output_t>::bits - sample_lanes<input_t>::bits>(ops_t::load(input + sampleIndex)));
+			}
+
+			return vectorSamplesCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename input_t, typename output_t>
+		static uint64_t narrow(const void* inputBuffer, void* outputBuffer, uint64_t samplesCount)
+		{
+			const input_t* input = reinterpret_cast<const input_t*>(inputBuffer);
+			output_t* output = reinterpret_cast<output_t*>(outputBuffer);
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(7u);
+
+			for (uint64_t sampleIndex = 0u; sampleIndex != vectorSamplesCount; sampleIndex += 8u)
+			{
+				ops_t::store(output + sampleIndex, ops_t::template scale_down<sample_lanes<input_t>::bits - sample_lanes<output_t>::bits>(ops_t::load(input + sampleIndex)));
+			}
+
+			return vectorSamplesCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename input_t>
+		static uint64_t integer_to_float(const void* inputBuffer, void* outputBuffer, uint64_t samplesCount)
+		{
+			const input_t* input = reinterpret_cast<const input_t*>(inputBuffer);
+			float* output = reinterpret_cast<float*>(outputBuffer);
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(7u);
+			const float multiplier = 1.0f / (static_cast<float>(std::numeric_limits<input_t>::max()) + 1.0f);
+
+			for (uint64_t sampleIndex = 0u; sampleIndex != vectorSamplesCount; sampleIndex += 8u)
+			{
+				ops_t::store_float(output + sampleIndex, ops_t::load(input + sampleIndex), multiplier);
+			}
+
+			return vectorSamplesCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename input_t>
+		static uint64_t integer_to_double(const void* inputBuffer, void* outputBuffer, uint64_t samplesCount)
+		{
+			const input_t* input = reinterpret_cast<const input_t*>(inputBuffer);
+			double* output = reinterpret_cast<double*>(outputBuffer);
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(7u);
+			const double multiplier = 1.0 / (static_cast<double>(std::numeric_limits<input_t>::max()) + 1.0);
+
+			for (uint64_t sampleIndex = 0u; sampleIndex != vectorSamplesCount; sampleIndex += 8u)
+			{
+				ops_t::store_double(output + sampleIndex, ops_t::load(input + sampleIndex), multiplier);
+			}
+
+			return vectorSamplesCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// The maximum of int32_t is not a float, ops_t fixes the lanes overflowing it instead.
+		template <typename output_t>
+		static uint64_t float_to_integer(const void* inputBuffer, void* outputBuffer, uint64_t samplesCount)
+		{
+			const float* input = reinterpret_cast<const float*>(inputBuffer);
+			output_t* output = reinterpret_cast<output_t*>(outputBuffer);
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(7u);
+			const float multiplier = -static_cast<float>(std::numeric_limits<output_t>::min());
+
+			for (uint64_t sampleIndex = 0u; sampleIndex != vectorSamplesCount; sampleIndex += 8u)
+			{
+				ops_t::store(output + sampleIndex, ops_t::template load_float<(sample_lanes<output_t>::bits < 32u)>(input + sampleIndex, multiplier));
+			}
+
+			return vectorSamplesCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename output_t>
+		static uint64_t double_to_integer(const void* inputBuffer, void* outputBuffer, uint64_t samplesCount)
+		{
+			const double* input = reinterpret_cast<const double*>(inputBuffer);
+			output_t* output = reinterpret_cast<output_t*>(outputBuffer);
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(7u);
+			const double multiplier = -static_cast<double>(std::numeric_limits<output_t>::min());
+
+			for (uint64_t sampleIndex = 0u; sampleIndex != vectorSamplesCount; sampleIndex += 8u)
+			{
+				ops_t::store(output + sampleIndex, ops_t::load_double(input + sampleIndex, multiplier));
+			}
+
+			return vectorSamplesCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static uint64_t float_to_double(const void* inputBuffer, void* outputBuffer, uint64_t samplesCount)
+		{
+			const float* input = reinterpret_cast<const float*>(inputBuffer);
+			double* output = reinterpret_cast<double*>(outputBuffer);
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(7u);
+
+			for (uint64_t sampleIndex = 0u; sampleIndex != vectorSamplesCount; sampleIndex += 8u)
+			{
+				ops_t::float_to_double(input + sampleIndex, output + sampleIndex);
+			}
+
+			return vectorSamplesCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static uint64_t double_to_float(const void* inputBuffer, void* outputBuffer, uint64_t samplesCount)
+		{
+			const double* input = reinterpret_cast<const double*>(inputBuffer);
+			float* output = reinterpret_cast<float*>(outputBuffer);
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(7u);
+
+			for (uint64_t sampleIndex = 0u; sampleIndex != vectorSamplesCount; sampleIndex += 8u)
+			{
+				ops_t::double_to_float(input + sampleIndex, output + sampleIndex);
+			}
+
+			return vectorSamplesCount;
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// sse_samples_ops - samples_kernels operations on 8 samples held in two SSE4.1 registers
+	///
+	/// level_t only keeps the instances of different levels apart, levels with wider floating point
+	/// registers derive from it and hide the floating point operations.
+	//-------------------------------------------------------------------------------------------------
+	template <typename level_t>
+	class sse_samples_ops
+	{
+	public:
+		class int_vector
+		{
+		public:
+			__m128i					m_low;
+			__m128i					m_high;
+		};
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		template <typename sample_t>
+		forceinline static int_vector load(const sample_t* input)
+		{
+			return int_vector{ sample_lanes<sample_t>::load(input), sample_lanes<sample_t>::load(input + 4u) };
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename sample_t>
+		forceinline static void store(sample_t* output, const int_vector& lanes)
+		{
+			sample_lanes<sample_t>::store(output, lanes.m_low);
+			sample_lanes<sample_t>::store(output + 4u, lanes.m_high);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <uint32_t shift>
+		forceinline static int_vector scale_up(const int_vector& lanes)
+		{
+			const __m128i lowBits = _mm_set1_epi32((1 << shift) - 1);
+
+			return int_vector{
+				_mm_or_si128(_mm_slli_epi32(lanes.m_low, shift), _mm_andnot_si128(_mm_srai_epi32(lanes.m_low, 31), lowBits)),
+				_mm_or_si128(_mm_slli_epi32(lanes.m_high, shift), _mm_andnot_si128(_mm_srai_epi32(lanes.m_high, 31), lowBits)) };
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Same as scale_down_sample, the ~sign fill is subtracted before rounding half up.
+		template <uint32_t shift>
+		forceinline static int_vector scale_down(const int_vector& lanes)
+		{
+			return int_vector{ scale_down<shift>(lanes.m_low), scale_down<shift>(lanes.m_high) };
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <uint32_t shift>
+		forceinline static __m128i scale_down(__m128i lanes)
+		{
+			const __m128i sign = _mm_srai_epi32(lanes, 31);
+			const __m128i unfilled = _mm_sub_epi32(lanes, _mm_andnot_si128(sign, _mm_set1_epi32((1 << shift) - 1)));
+			const __m128i rounded = _mm_srai_epi32(_mm_add_epi32(unfilled, _mm_set1_epi32(1 << (shift - 1u))), shift);
+
+			return _mm_xor_si128(rounded, _mm_cmpeq_epi32(rounded, _mm_xor_si128(sign, _mm_set1_epi32(-1))));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline static void store_float(float* output, const int_vector& lanes, float multiplier)
+		{
+			const __m128 multiplierVector = _mm_set1_ps(multiplier);
+
+			_mm_storeu_ps(output, _mm_mul_ps(_mm_cvtepi32_ps(lanes.m_low), multiplierVector));
+			_mm_storeu_ps(output + 4u, _mm_mul_ps(_mm_cvtepi32_ps(lanes.m_high), multiplierVector));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline static void store_double(double* output, const int_vector& lanes, double multiplier)
+		{
+			const __m128d multiplierVector = _mm_set1_pd(multiplier);
+
+			_mm_storeu_pd(output, _mm_mul_pd(_mm_cvtepi32_pd(lanes.m_low), multiplierVector));
+			_mm_storeu_pd(output + 2u, _mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(lanes.m_low, lanes.m_low)), multiplierVector));
+			_mm_storeu_pd(output + 4u, _mm_mul_pd(_mm_cvtepi32_pd(lanes.m_high), multiplierVector));
+			_mm_storeu_pd(output + 6u, _mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(lanes.m_high, lanes.m_high)), multiplierVector));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// NaN and values below the range give the minimum, as max(x, minimum) returns the minimum for
+		/// NaN. Without an exact maximum cvttps2dq returns 0x80000000 for scaled values from 2^31 up,
+		/// xor with the comparison mask turns them into 0x7FFFFFFF.
+		template <bool exact_maximum>
+		forceinline static int_vector load_float(const float* input, float multiplier)
+		{
+			const __m128 multiplierVector = _mm_set1_ps(multiplier);
+			const __m128 minimumVector = _mm_set1_ps(-multiplier);
+			const __m128 maximumVector = _mm_set1_ps(exact_maximum ? multiplier - 1.0f : multiplier);
+
+			const auto ConvertFour = [&](const float* inputPart)->__m128i
+			{
+				const __m128 scaled = _mm_max_ps(_mm_mul_ps(_mm_loadu_ps(inputPart), multiplierVector), minimumVector);
+
+				if (exact_maximum)
+				{
+					return _mm_cvttps_epi32(_mm_min_ps(scaled, maximumVector));
+				}
+
+				return _mm_xor_si128(_mm_cvttps_epi32(scaled), _mm_castps_si128(_mm_cmpge_ps(scaled, maximumVector)));
+			};
+
+			return int_vector{ ConvertFour(input), ConvertFour(input + 4u) };
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Every maximum is exact in double.
+		forceinline static int_vector load_double(const double* input, double multiplier)
+		{
+			const __m128d multiplierVector = _mm_set1_pd(multiplier);
+			const __m128d minimumVector = _mm_set1_pd(-multiplier);
+			const __m128d maximumVector = _mm_set1_pd(multiplier - 1.0);
+
+			const auto ConvertTwo = [&](const double* inputPart)->__m128i
+			{
+				const __m128d scaled = _mm_max_pd(_mm_mul_pd(_mm_loadu_pd(inputPart), multiplierVector), minimumVector);
+
+				return _mm_cvttpd_epi32(_mm_min_pd(scaled, maximumVector));
+			};
+
+			return int_vector{
+				_mm_unpacklo_epi64(ConvertTwo(input), ConvertTwo(input + 2u)),
+				_mm_unpacklo_epi64(ConvertTwo(input + 4u), ConvertTwo(input + 6u)) };
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline static void float_to_double(const float* input, double* output)
+		{
+			const __m128 low = _mm_loadu_ps(input);
+			const __m128 high = _mm_loadu_ps(input + 4u);
+
+			_mm_storeu_pd(output, _mm_cvtps_pd(low));
+			_mm_storeu_pd(output + 2u, _mm_cvtps_pd(_mm_movehl_ps(low, low)));
+			_mm_storeu_pd(output + 4u, _mm_cvtps_pd(high));
+			_mm_storeu_pd(output + 6u, _mm_cvtps_pd(_mm_movehl_ps(high, high)));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline static void double_to_float(const double* input, float* output)
+		{
+			_mm_storeu_ps(output, _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(input)), _mm_cvtpd_ps(_mm_loadu_pd(input + 2u))));
+			_mm_storeu_ps(output + 4u, _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(input + 4u)), _mm_cvtpd_ps(_mm_loadu_pd(input + 6u))));
+		}
+	};
+}
@@ -0,0 +1,100 @@
+#include "platform.h"
+#include "Miscellaneous.h"
+
+#pragma GCC target("avx")
+
+#include "SamplesKernels.h"
+
+
+namespace aux
+{
+	namespace
+	{
+		//---------------------------------------------------------------------------------------------
+		/// AvxSamplesOps - integer lanes stay in SSE registers, AVX has no 256 bit integer operations
+		//---------------------------------------------------------------------------------------------
+		class AvxSamplesOps : public sse_samples_ops<AvxSamplesOps>
+		{
+		public:
+			//-----------------------------------------------------------------------------------------
+			forceinline static __m256i join(const int_vector& lanes)
+			{
+				return _mm256_insertf128_si256(_mm256_castsi128_si256(lanes.m_low), lanes.m_high, 1);
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static void store_float(float* output, const int_vector& lanes, float multiplier)
+			{
+				_mm256_storeu_ps(output, _mm256_mul_ps(_mm256_cvtepi32_ps(join(lanes)), _mm256_set1_ps(multiplier)));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static void store_double(double* output, const int_vector& lanes, double multiplier)
+			{
+				const __m256d multiplierVector = _mm256_set1_pd(multiplier);
+
+				_mm256_storeu_pd(output, _mm256_mul_pd(_mm256_cvtepi32_pd(lanes.m_low), multiplierVector));
+				_mm256_storeu_pd(output + 4u, _mm256_mul_pd(_mm256_cvtepi32_pd(lanes.m_high), multiplierVector));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			template <bool exact_maximum>
+			forceinline static int_vector load_float(const float* input, float multiplier)
+			{
+				const __m256 multiplierVector = _mm256_set1_ps(multiplier);
+				const __m256 scaled = _mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(input), multiplierVector), _mm256_set1_ps(-multiplier));
+				__m256i lanes;
+
+				if (exact_maximum)
+				{
+					lanes = _mm256_cvttps_epi32(_mm256_min_ps(scaled, _mm256_set1_ps(multiplier - 1.0f)));
+				}
+				else
+				{
+					lanes = _mm256_castps_si256(_mm256_xor_ps(_mm256_castsi256_ps(_mm256_cvttps_epi32(scaled)), _mm256_cmp_ps(scaled, multiplierVector, _CMP_GE_OQ)));
+				}
+
+				return int_vector{ _mm256_castsi256_si128(lanes), _mm256_extractf128_si256(lanes, 1) };
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static int_vector load_double(const double* input, double multiplier)
+			{
+				const __m256d multiplierVector = _mm256_set1_pd(multiplier);
+				const __m256d minimumVector = _mm256_set1_pd(-multiplier);
+				const __m256d maximumVector = _mm256_set1_pd(multiplier - 1.0);
+
+				const auto ConvertFour = [&](const double* inputPart)->__m128i
+				{
+					const __m256d scaled = _mm256_max_pd(_mm256_mul_pd(_mm256_loadu_pd(inputPart), multiplierVector), minimumVector);
+
+					return _mm256_cvttpd_epi32(_mm256_min_pd(scaled, maximumVector));
+				};
+
+				return int_vector{ ConvertFour(input), ConvertFour(input + 4u) };
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static void float_to_double(const float* input, double* output)
+			{
+				_mm256_storeu_pd(output, _mm256_cvtps_pd(_mm_loadu_ps(input)));
+				_mm256_storeu_pd(output + 4u, _mm256_cvtps_pd(_mm_loadu_ps(input + 4u)));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static void double_to_float(const double* input, float* output)
+			{
+				_mm_storeu_ps(output, _mm256_cvtpd_ps(_mm256_loadu_pd(input)));
+				_mm_storeu_ps(output + 4u, _mm256_cvtpd_ps(_mm256_loadu_pd(input + 4u)));
+			}
+		};
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	const SamplesKernels::Table& SamplesKernels::AvxTable()
+	{
+		static const Table table = samples_kernels<AvxSamplesOps>::MakeTable();
+
+		return table;
+	}
+}
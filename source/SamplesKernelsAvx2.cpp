@@ -0,0 +1,194 @@
+#include "platform.h"
+#include "Miscellaneous.h"
+
+#pragma GCC target("avx2,fma,f16c")
+
+#include "SamplesKernels.h"
+
+
+namespace aux
+{
+	namespace
+	{
+		//---------------------------------------------------------------------------------------------
+		/// Avx2SamplesOps - 8 samples in one AVX register
+		//---------------------------------------------------------------------------------------------
+		class Avx2SamplesOps
+		{
+		public:
+			typedef __m256i				int_vector;
+
+		public:
+			//-----------------------------------------------------------------------------------------
+			forceinline static int_vector load(const int16_t* input)
+			{
+				return _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input)));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			/// 24 bytes are read as two halves, a single 32 byte load could pass the end of the buffer.
+			forceinline static int_vector load(const int24_t* input)
+			{
+				return _mm256_set_m128i(sample_lanes<int24_t>::load(input + 4u), sample_lanes<int24_t>::load(input));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static int_vector load(const int32_t* input)
+			{
+				return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			/// packssdw works within 128 bit halves, the permute gathers both packed quarters.
+			forceinline static void store(int16_t* output, int_vector lanes)
+			{
+				const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lanes, lanes), 0x08);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm256_castsi256_si128(packed));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static void store(int24_t* output, int_vector lanes)
+			{
+				sample_lanes<int24_t>::store(output, _mm256_castsi256_si128(lanes));
+				sample_lanes<int24_t>::store(output + 4u, _mm256_extracti128_si256(lanes, 1));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static void store(int32_t* output, int_vector lanes)
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(output), lanes);
+			}
+
+			//-----------------------------------------------------------------------------------------
+			template <uint32_t shift>
+			forceinline static int_vector scale_up(int_vector lanes)
+			{
+				return _mm256_or_si256(_mm256_slli_epi32(lanes, shift), _mm256_andnot_si256(_mm256_srai_epi32(lanes, 31), _mm256_set1_epi32((1 << shift) - 1)));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			template <uint32_t shift>
+			forceinline static int_vector scale_down(int_vector lanes)
+			{
+				const __m256i sign = _mm256_srai_epi32(lanes, 31);
+				const __m256i unfilled = _mm256_sub_epi32(lanes, _mm256_andnot_si256(sign, _mm256_set1_epi32((1 << shift) - 1)));
+				const __m256i rounded = _mm256_srai_epi32(_mm256_add_epi32(unfilled, _mm256_set1_epi32(1 << (shift - 1u))), shift);
+
+				return _mm256_xor_si256(rounded, _mm256_cmpeq_epi32(rounded, _mm256_xor_si256(sign, _mm256_set1_epi32(-1))));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static void store_float(float* output, int_vector lanes, float multiplier)
+			{
+				_mm256_storeu_ps(output, _mm256_mul_ps(_mm256_cvtepi32_ps(lanes), _mm256_set1_ps(multiplier)));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static void store_double(double* output, int_vector lanes, double multiplier)
+			{
+				const __m256d multiplierVector = _mm256_set1_pd(multiplier);
+
+				_mm256_storeu_pd(output, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(lanes)), multiplierVector));
+				_mm256_storeu_pd(output + 4u, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(lanes, 1)), multiplierVector));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			template <bool exact_maximum>
+			forceinline static int_vector load_float(const float* input, float multiplier)
+			{
+				const __m256 multiplierVector = _mm256_set1_ps(multiplier);
+				const __m256 scaled = _mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(input), multiplierVector), _mm256_set1_ps(-multiplier));
+
+				if (exact_maximum)
+				{
+					return _mm256_cvttps_epi32(_mm256_min_ps(scaled, _mm256_set1_ps(multiplier - 1.0f)));
+				}
+
+				return _mm256_xor_si256(_mm256_cvttps_epi32(scaled), _mm256_castps_si256(_mm256_cmp_ps(scaled, multiplierVector, _CMP_GE_OQ)));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static int_vector load_double(const double* input, double multiplier)
+			{
+				const __m256d multiplierVector = _mm256_set1_pd(multiplier);
+				const __m256d minimumVector = _mm256_set1_pd(-multiplier);
+				const __m256d maximumVector = _mm256_set1_pd(multiplier - 1.0);
+
+				const auto ConvertFour = [&](const double* inputPart)->__m128i
+				{
+					const __m256d scaled = _mm256_max_pd(_mm256_mul_pd(_mm256_loadu_pd(inputPart), multiplierVector), minimumVector);
+
+					return _mm256_cvttpd_epi32(_mm256_min_pd(scaled, maximumVector));
+				};
+
+				return _mm256_set_m128i(ConvertFour(input + 4u), ConvertFour(input));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static void float_to_double(const float* input, double* output)
+			{
+				_mm256_storeu_pd(output, _mm256_cvtps_pd(_mm_loadu_ps(input)));
+				_mm256_storeu_pd(output + 4u, _mm256_cvtps_pd(_mm_loadu_ps(input + 4u)));
+			}
+
+			//-----------------------------------------------------------------------------------------
+			forceinline static void double_to_float(const double* input, float* output)
+			{
+				_mm_storeu_ps(output, _mm256_cvtpd_ps(_mm256_loadu_pd(input)));
+				_mm_storeu_ps(output + 4u, _mm256_cvtpd_ps(_mm256_loadu_pd(input + 4u)));
+			}
+		};
+
+		//---------------------------------------------------------------------------------------------
+		/// half kernels, F16C comes with this level only. Other types go to and from half via float.
+		//---------------------------------------------------------------------------------------------
+		uint64_t HalfToFloat(const void* inputBuffer, void* outputBuffer, uint64_t samplesCount)
+		{
+			const half* input = reinterpret_cast<const half*>(inputBuffer);
+			float* output = reinterpret_cast<float*>(outputBuffer);
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(7u);
+
+			for (uint64_t sampleIndex = 0u; sampleIndex != vectorSamplesCount; sampleIndex += 8u)
+			{
+				_mm256_storeu_ps(output + sampleIndex, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + sampleIndex))));
+			}
+
+			return vectorSamplesCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		uint64_t FloatToHalf(const void* inputBuffer, void* outputBuffer, uint64_t samplesCount)
+		{
+			const float* input = reinterpret_cast<const float*>(inputBuffer);
+			half* output = reinterpret_cast<half*>(outputBuffer);
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(7u);
+
+			for (uint64_t sampleIndex = 0u; sampleIndex != vectorSamplesCount; sampleIndex += 8u)
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output + sampleIndex), _mm256_cvtps_ph(_mm256_loadu_ps(input + sampleIndex), _MM_FROUND_TO_NEAREST_INT));
+			}
+
+			return vectorSamplesCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		SamplesKernels::Table MakeAvx2Table()
+		{
+			SamplesKernels::Table table = samples_kernels<Avx2SamplesOps>::MakeTable();
+
+			table.m_kernels[static_cast<uint32_t>(SampleType::Half)][static_cast<uint32_t>(SampleType::Float)] = &HalfToFloat;
+			table.m_kernels[static_cast<uint32_t>(SampleType::Float)][static_cast<uint32_t>(SampleType::Half)] = &FloatToHalf;
+
+			return table;
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	const SamplesKernels::Table& SamplesKernels::Avx2Table()
+	{
+		static const Table table = MakeAvx2Table();
+
+		return table;
+	}
+}
@@ -0,0 +1,331 @@
+#pragma once
+
+#include "Miscellaneous.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// quantize_saturate - float/double to int[x]_t policy of samples_quantizer
+	///
+	/// The samples_converter conversion itself: scales by 2^(bits - 1), truncates and saturates.
+	//-------------------------------------------------------------------------------------------------
+	class quantize_saturate
+	{
+	public:
+		template <typename input_t, typename output_t>
+		forceinline static void quantize(const void* inputBuffer, output_t* outputBuffer, uint64_t samplesCount)
+		{
+			samples_converter<input_t, output_t>::convert(inputBuffer, outputBuffer, samplesCount);
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// quantize_wrap - float/double to int[x]_t policy of samples_quantizer
+	///
+	/// Scales by 2^(bits - 1), truncates into int32 and keeps the low bits, so values out of [-1, 1)
+	/// wrap around. Like the hardware conversion, values out of the int32 range and NaN give the int32
+	/// minimum before wrapping. No comparisons, the cheapest policy for input known to be in range.
+	//-------------------------------------------------------------------------------------------------
+	class quantize_wrap
+	{
+	public:
+		template <typename input_t, typename output_t>
+		static void quantize(const void* inputBuffer, output_t* outputBuffer, uint64_t samplesCount)
+		{
+			static_assert(std::is_floating_point<input_t>::value && sample_lanes<output_t>::vectorized, "Invalid input or output type.");
+
+			const input_t* input = reinterpret_cast<const input_t*>(inputBuffer);
+			const input_t multiplier = -static_cast<input_t>(std::numeric_limits<output_t>::min());
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(3u);
+			uint64_t sampleIndex = 0u;
+
+			for (; sampleIndex != vectorSamplesCount; sampleIndex += 4u)
+			{
+				sample_lanes<output_t>::store(outputBuffer + sampleIndex, wrap<sample_lanes<output_t>::bits>(truncate(input + sampleIndex, multiplier)));
+			}
+
+			for (; sampleIndex != samplesCount; ++sampleIndex)
+			{
+				const uint32_t truncated = static_cast<uint32_t>(truncate(input[sampleIndex] * multiplier));
+
+				outputBuffer[sampleIndex] = static_cast<output_t>(static_cast<int32_t>(truncated << (32u - sample_lanes<output_t>::bits)) >> (32u - sample_lanes<output_t>::bits));
+			}
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		forceinline static __m128i truncate(const float* input, float multiplier)
+		{
+			return _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(input), _mm_set1_ps(multiplier)));
+		}
+
+		forceinline static __m128i truncate(const double* input, double multiplier)
+		{
+			const __m128d vectorMultiplier = _mm_set1_pd(multiplier);
+			const __m128i low = _mm_cvttpd_epi32(_mm_mul_pd(_mm_loadu_pd(input), vectorMultiplier));
+			const __m128i high = _mm_cvttpd_epi32(_mm_mul_pd(_mm_loadu_pd(input + 2u), vectorMultiplier));
+
+			return _mm_unpacklo_epi64(low, high);
+		}
+
+		forceinline static int32_t truncate(float input)
+		{
+			return _mm_cvtt_ss2si(_mm_set_ss(input));
+		}
+
+		forceinline static int32_t truncate(double input)
+		{
+			return _mm_cvttsd_si32(_mm_set_sd(input));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <uint32_t bits>
+		forceinline static __m128i wrap(__m128i lanes)
+		{
+			return _mm_srai_epi32(_mm_slli_epi32(lanes, 32u - bits), 32u - bits);
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// quantize_dither - float/double to int[x]_t policy of samples_quantizer
+	///
+	/// Adds TPDF dither of +-1 LSB, rounds half up and saturates, NaN gives the minimum. The noise
+	/// comes from 8 xorshift32 lanes, a TPDF value is the difference of two uniform ones. The math is
+	/// in float for int16_t and in double for wider outputs, whose LSB is below float precision. With
+	/// noise_shaping every channel feeds its quantization error back with first order highpass
+	/// shaping, moving the noise power up the spectrum. The feedback is serial per sample, the noise
+	/// is still generated vectorized.
+	///
+	/// The policy keeps the generator and the shaping state, use one instance per stream. channelsCount
+	/// tells the interleaved channels apart for noise shaping.
+	//-------------------------------------------------------------------------------------------------
+	template <bool noise_shaping = false>
+	class quantize_dither
+	{
+	private:
+		static constexpr uint32_t	NoiseBlockLength = 64u;
+
+		__m128i						m_firstState;
+		__m128i						m_secondState;
+		uint32_t					m_channelIndex;
+		std::vector<double>			m_errors;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		explicit quantize_dither(uint32_t channelsCount = 1u, uint32_t seed = 0x9E3779B9u) :
+			m_channelIndex(0u),
+			m_errors(noise_shaping ? channelsCount : 0u, 0.0)
+		{
+			assert(channelsCount != 0u);
+
+			uint32_t lanes[8];
+
+			// xorshift32 lanes must not start at zero, spreads the seed with the splitmix32 finalizer
+			for (uint32_t laneIndex = 0u; laneIndex != 8u; ++laneIndex)
+			{
+				uint32_t lane = seed + (laneIndex + 1u) * 0x9E3779B9u;
+
+				lane = (lane ^ (lane >> 16)) * 0x85EBCA6Bu;
+				lane = (lane ^ (lane >> 13)) * 0xC2B2AE35u;
+				lanes[laneIndex] = (lane ^ (lane >> 16)) | 1u;
+			}
+
+			m_firstState = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+			m_secondState = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + 4u));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename input_t, typename output_t>
+		void quantize(const void* inputBuffer, output_t* outputBuffer, uint64_t samplesCount)
+		{
+			static_assert(std::is_floating_point<input_t>::value && sample_lanes<output_t>::vectorized, "Invalid input or output type.");
+
+			typedef typename std::conditional<sample_lanes<output_t>::bits <= 16u, float, double>::type math_t;
+
+			const input_t* input = reinterpret_cast<const input_t*>(inputBuffer);
+			alignas(16) float noise[NoiseBlockLength];
+
+			for (uint64_t blockStart = 0u; blockStart < samplesCount; blockStart += NoiseBlockLength)
+			{
+				const uint32_t blockLength = static_cast<uint32_t>(std::min<uint64_t>(NoiseBlockLength, samplesCount - blockStart));
+
+				GenerateNoise(noise);
+
+				if (noise_shaping)
+				{
+					ShapeBlock<math_t>(input + blockStart, outputBuffer + blockStart, noise, blockLength);
+				}
+				else
+				{
+					DitherBlock<math_t>(input + blockStart, outputBuffer + blockStart, noise, blockLength);
+				}
+			}
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		forceinline static __m128i NextLanes(__m128i& state)
+		{
+			state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+			state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+			state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+
+			return state;
+		}
+
+		/// Top 24 bits of the lanes as floats in [0, 1).
+		forceinline static __m128 Uniform(__m128i lanes)
+		{
+			return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(lanes, 8)), _mm_set1_ps(1.0f / 16777216.0f));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		void GenerateNoise(float* noise)
+		{
+			for (uint32_t noiseIndex = 0u; noiseIndex != NoiseBlockLength; noiseIndex += 4u)
+			{
+				const __m128 first = Uniform(NextLanes(m_firstState));
+				const __m128 second = Uniform(NextLanes(m_secondState));
+
+				_mm_store_ps(noise + noiseIndex, _mm_sub_ps(first, second));
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Four dithered samples rounded half up and saturated, in float math.
+		template <typename output_t>
+		forceinline static __m128i DitherLanes(__m128 input, const float* noise)
+		{
+			const __m128 multiplier = _mm_set1_ps(-static_cast<float>(std::numeric_limits<output_t>::min()));
+			const __m128 minOutput = _mm_set1_ps(static_cast<float>(std::numeric_limits<output_t>::min()));
+			const __m128 maxOutput = _mm_set1_ps(static_cast<float>(std::numeric_limits<output_t>::max()));
+			const __m128 dithered = _mm_add_ps(_mm_mul_ps(input, multiplier), _mm_load_ps(noise));
+			const __m128 rounded = _mm_floor_ps(_mm_add_ps(dithered, _mm_set1_ps(0.5f)));
+
+			// max_ps returns its second operand for NaN, so NaN goes to the minimum as in RoundDithered
+			return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(rounded, minOutput), maxOutput));
+		}
+
+		/// Two dithered samples rounded half up and saturated, in double math, in the low lanes.
+		template <typename output_t>
+		forceinline static __m128i DitherLanes(__m128d input, const float* noise)
+		{
+			const __m128d multiplier = _mm_set1_pd(-static_cast<double>(std::numeric_limits<output_t>::min()));
+			const __m128d minOutput = _mm_set1_pd(static_cast<double>(std::numeric_limits<output_t>::min()));
+			const __m128d maxOutput = _mm_set1_pd(static_cast<double>(std::numeric_limits<output_t>::max()));
+			const __m128d dithered = _mm_add_pd(_mm_mul_pd(input, multiplier), _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(noise)))));
+			const __m128d rounded = _mm_floor_pd(_mm_add_pd(dithered, _mm_set1_pd(0.5)));
+
+			return _mm_cvtpd_epi32(_mm_min_pd(_mm_max_pd(rounded, minOutput), maxOutput));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename output_t>
+		forceinline static __m128i DitherLanes(const float* input, const float* noise, float)
+		{
+			return DitherLanes<output_t>(_mm_loadu_ps(input), noise);
+		}
+
+		template <typename output_t>
+		forceinline static __m128i DitherLanes(const double* input, const float* noise, float)
+		{
+			return DitherLanes<output_t>(_mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(input)), _mm_cvtpd_ps(_mm_loadu_pd(input + 2u))), noise);
+		}
+
+		template <typename output_t>
+		forceinline static __m128i DitherLanes(const float* input, const float* noise, double)
+		{
+			const __m128 inputLanes = _mm_loadu_ps(input);
+
+			return _mm_unpacklo_epi64(DitherLanes<output_t>(_mm_cvtps_pd(inputLanes), noise), DitherLanes<output_t>(_mm_cvtps_pd(_mm_movehl_ps(inputLanes, inputLanes)), noise + 2u));
+		}
+
+		template <typename output_t>
+		forceinline static __m128i DitherLanes(const double* input, const float* noise, double)
+		{
+			return _mm_unpacklo_epi64(DitherLanes<output_t>(_mm_loadu_pd(input), noise), DitherLanes<output_t>(_mm_loadu_pd(input + 2u), noise + 2u));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Rounds the dithered value half up and saturates, in the order the vector loop does.
+		template <typename output_t, typename math_t>
+		forceinline static math_t RoundDithered(math_t dithered)
+		{
+			constexpr math_t minOutput = static_cast<math_t>(std::numeric_limits<output_t>::min());
+			constexpr math_t maxOutput = static_cast<math_t>(std::numeric_limits<output_t>::max());
+
+			const math_t rounded = std::floor(dithered + static_cast<math_t>(0.5));
+
+			return rounded > minOutput ? (rounded < maxOutput ? rounded : maxOutput) : minOutput;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename math_t, typename input_t, typename output_t>
+		static void DitherBlock(const input_t* input, output_t* output, const float* noise, uint32_t blockLength)
+		{
+			const math_t multiplier = -static_cast<math_t>(std::numeric_limits<output_t>::min());
+			const uint32_t vectorBlockLength = blockLength & ~3u;
+			uint32_t sampleIndex = 0u;
+
+			for (; sampleIndex != vectorBlockLength; sampleIndex += 4u)
+			{
+				sample_lanes<output_t>::store(output + sampleIndex, DitherLanes<output_t>(input + sampleIndex, noise + sampleIndex, math_t()));
+			}
+
+			for (; sampleIndex != blockLength; ++sampleIndex)
+			{
+				const math_t dithered = static_cast<math_t>(input[sampleIndex]) * multiplier + static_cast<math_t>(noise[sampleIndex]);
+
+				output[sampleIndex] = static_cast<output_t>(static_cast<int32_t>(RoundDithered<output_t>(dithered)));
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename math_t, typename input_t, typename output_t>
+		void ShapeBlock(const input_t* input, output_t* output, const float* noise, uint32_t blockLength)
+		{
+			const math_t multiplier = -static_cast<math_t>(std::numeric_limits<output_t>::min());
+			const math_t errorLimit = static_cast<math_t>(2.0);
+			const uint32_t channelsCount = static_cast<uint32_t>(m_errors.size());
+
+			for (uint32_t sampleIndex = 0u; sampleIndex != blockLength; ++sampleIndex)
+			{
+				double& error = m_errors[m_channelIndex];
+				const math_t wanted = static_cast<math_t>(input[sampleIndex]) * multiplier - static_cast<math_t>(error);
+				const math_t rounded = RoundDithered<output_t>(wanted + static_cast<math_t>(noise[sampleIndex]));
+				const math_t newError = rounded - wanted;
+
+				// Clipping makes huge errors, limiting them keeps the feedback stable
+				error = newError > -errorLimit ? (newError < errorLimit ? newError : errorLimit) : -errorLimit;
+				output[sampleIndex] = static_cast<output_t>(static_cast<int32_t>(rounded));
+
+				if (++m_channelIndex == channelsCount)
+				{
+					m_channelIndex = 0u;
+				}
+			}
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// samples_quantizer
+	///
+	/// float/double to int[x]_t conversion with a policy picked at compile time: quantize_saturate
+	/// (the default, samples_converter itself), quantize_wrap or quantize_dither. Takes the policy
+	/// constructor arguments, e.g. samples_quantizer<float, int16_t, quantize_dither<true>> q(2u).
+	//-------------------------------------------------------------------------------------------------
+	template <typename input_t, typename output_t, typename policy_t = quantize_saturate>
+	class samples_quantizer : private policy_t
+	{
+	public:
+		using policy_t::policy_t;
+
+		samples_quantizer() = default;
+
+		forceinline void convert(const void* inputBuffer, output_t* outputBuffer, uint64_t samplesCount)
+		{
+			policy_t::template quantize<input_t, output_t>(inputBuffer, outputBuffer, samplesCount);
+		}
+	};
+}
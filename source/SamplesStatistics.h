@@ -0,0 +1,450 @@
+#pragma once
+
+#include "Miscellaneous.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// samples_measurement - peak, RMS and DC offset, full scale of int[x]_t is 1 as for
+	/// samples_converter to float
+	//-------------------------------------------------------------------------------------------------
+	class samples_measurement
+	{
+	public:
+		double						m_peak;
+		double						m_rms;
+		double						m_dcOffset;
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// samples_accumulator - running sums of a measurement over any number of buffers
+	//-------------------------------------------------------------------------------------------------
+	class samples_accumulator
+	{
+	public:
+		double						m_peak = 0.0;
+		double						m_sum = 0.0;
+		double						m_squaresSum = 0.0;
+		uint64_t					m_count = 0u;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		samples_measurement result() const
+		{
+			const double count = static_cast<double>(std::max<uint64_t>(m_count, 1u));
+
+			return samples_measurement{ m_peak, std::sqrt(m_squaresSum / count), m_sum / count };
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// sample_math_lanes - four samples of every type loaded into and stored from the lanes they are
+	/// computed in: float for int16_t, int24_t and float, double for int32_t and double, whose values
+	/// float does not hold exactly. Stores into integers round to nearest and saturate, NaN gives the
+	/// minimum.
+	//-------------------------------------------------------------------------------------------------
+	class sample_math_lanes
+	{
+	public:
+		class double_lanes
+		{
+		public:
+			__m128d					m_low;
+			__m128d					m_high;
+		};
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		forceinline static __m128 load(const int16_t* input)
+		{
+			return _mm_cvtepi32_ps(sample_lanes<int16_t>::load(input));
+		}
+
+		forceinline static __m128 load(const int24_t* input)
+		{
+			return _mm_cvtepi32_ps(sample_lanes<int24_t>::load(input));
+		}
+
+		forceinline static __m128 load(const float* input)
+		{
+			return _mm_loadu_ps(input);
+		}
+
+		forceinline static double_lanes load(const int32_t* input)
+		{
+			const __m128i lanes = sample_lanes<int32_t>::load(input);
+
+			return double_lanes{ _mm_cvtepi32_pd(lanes), _mm_cvtepi32_pd(_mm_unpackhi_epi64(lanes, lanes)) };
+		}
+
+		forceinline static double_lanes load(const double* input)
+		{
+			return double_lanes{ _mm_loadu_pd(input), _mm_loadu_pd(input + 2u) };
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline static void store(int16_t* output, __m128 lanes)
+		{
+			sample_lanes<int16_t>::store(output, _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(lanes, _mm_set1_ps(-32768.0f)), _mm_set1_ps(32767.0f))));
+		}
+
+		forceinline static void store(int24_t* output, __m128 lanes)
+		{
+			sample_lanes<int24_t>::store(output, _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(lanes, _mm_set1_ps(-8388608.0f)), _mm_set1_ps(8388607.0f))));
+		}
+
+		forceinline static void store(float* output, __m128 lanes)
+		{
+			_mm_storeu_ps(output, lanes);
+		}
+
+		forceinline static void store(int32_t* output, const double_lanes& lanes)
+		{
+			const __m128d minimum = _mm_set1_pd(-2147483648.0);
+			const __m128d maximum = _mm_set1_pd(2147483647.0);
+			const __m128i low = _mm_cvtpd_epi32(_mm_min_pd(_mm_max_pd(lanes.m_low, minimum), maximum));
+			const __m128i high = _mm_cvtpd_epi32(_mm_min_pd(_mm_max_pd(lanes.m_high, minimum), maximum));
+
+			sample_lanes<int32_t>::store(output, _mm_unpacklo_epi64(low, high));
+		}
+
+		forceinline static void store(double* output, const double_lanes& lanes)
+		{
+			_mm_storeu_pd(output, lanes.m_low);
+			_mm_storeu_pd(output + 2u, lanes.m_high);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline static __m128 broadcast(float value)
+		{
+			return _mm_set1_ps(value);
+		}
+
+		forceinline static __m128d broadcast(double value)
+		{
+			return _mm_set1_pd(value);
+		}
+
+		forceinline static __m128 multiply(__m128 lanes, __m128 factor)
+		{
+			return _mm_mul_ps(lanes, factor);
+		}
+
+		forceinline static double_lanes multiply(const double_lanes& lanes, __m128d factor)
+		{
+			return double_lanes{ _mm_mul_pd(lanes.m_low, factor), _mm_mul_pd(lanes.m_high, factor) };
+		}
+
+		forceinline static __m128 add(__m128 first, __m128 second)
+		{
+			return _mm_add_ps(first, second);
+		}
+
+		forceinline static double_lanes add(const double_lanes& first, const double_lanes& second)
+		{
+			return double_lanes{ _mm_add_pd(first.m_low, second.m_low), _mm_add_pd(first.m_high, second.m_high) };
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Scalar store with the rounding and saturation of the vector one.
+		template <typename sample_t, typename math_t>
+		forceinline static void store(sample_t& output, math_t value, std::true_type /* integral */)
+		{
+			constexpr math_t minimum = static_cast<math_t>(std::numeric_limits<sample_t>::min());
+			constexpr math_t maximum = static_cast<math_t>(std::numeric_limits<sample_t>::max());
+
+			output = static_cast<sample_t>(static_cast<int32_t>(std::nearbyint(value > minimum ? (value < maximum ? value : maximum) : minimum)));
+		}
+
+		template <typename sample_t, typename math_t>
+		forceinline static void store(sample_t& output, math_t value, std::false_type /* integral */)
+		{
+			output = static_cast<sample_t>(value);
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// samples_statistics
+	///
+	/// Metering, gain and mixing over int16_t, int24_t, int32_t, float and double samples with SSE.
+	/// Measurements are summed in double; gain and mix compute in the lanes of sample_math_lanes, so
+	/// vector loops and scalar tails give identical samples.
+	//-------------------------------------------------------------------------------------------------
+	template <typename sample_t>
+	class samples_statistics
+	{
+		static_assert(sample_type<sample_t>::value != SampleType::Other && sample_type<sample_t>::value != SampleType::Half, "Invalid sample type.");
+
+	private:
+		typedef typename std::conditional<std::is_same<sample_t, int32_t>::value || std::is_same<sample_t, double>::value, double, float>::type math_t;
+		typedef std::integral_constant<bool, !std::is_floating_point<sample_t>::value> is_integral;
+
+		static constexpr double		Scale = std::is_floating_point<sample_t>::value ? 1.0 : 1.0 / (static_cast<double>(std::numeric_limits<sample_t>::max()) + 1.0);
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		/// Adds samples to the running sums of accumulator.
+		static void accumulate(samples_accumulator& accumulator, const sample_t* samples, uint64_t samplesCount)
+		{
+			const __m128d signMask = _mm_set1_pd(-0.0);
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(3u);
+			__m128d peakLanes = _mm_setzero_pd();
+			__m128d sumLanes = _mm_setzero_pd();
+			__m128d squaresSumLanes = _mm_setzero_pd();
+			uint64_t sampleIndex = 0u;
+
+			for (; sampleIndex != vectorSamplesCount; sampleIndex += 4u)
+			{
+				__m128d low, high;
+				load_double(samples + sampleIndex, low, high);
+
+				// max_pd returns its second operand for NaN, so NaN samples do not count for the peak
+				peakLanes = _mm_max_pd(_mm_andnot_pd(signMask, low), peakLanes);
+				peakLanes = _mm_max_pd(_mm_andnot_pd(signMask, high), peakLanes);
+				sumLanes = _mm_add_pd(sumLanes, _mm_add_pd(low, high));
+				squaresSumLanes = _mm_add_pd(squaresSumLanes, _mm_add_pd(_mm_mul_pd(low, low), _mm_mul_pd(high, high)));
+			}
+
+			double peak = std::max(_mm_cvtsd_f64(peakLanes), _mm_cvtsd_f64(_mm_unpackhi_pd(peakLanes, peakLanes)));
+			double sum = _mm_cvtsd_f64(sumLanes) + _mm_cvtsd_f64(_mm_unpackhi_pd(sumLanes, sumLanes));
+			double squaresSum = _mm_cvtsd_f64(squaresSumLanes) + _mm_cvtsd_f64(_mm_unpackhi_pd(squaresSumLanes, squaresSumLanes));
+
+			for (; sampleIndex != samplesCount; ++sampleIndex)
+			{
+				const double value = static_cast<double>(samples[sampleIndex]);
+				const double magnitude = std::fabs(value);
+
+				peak = magnitude > peak ? magnitude : peak;
+				sum += value;
+				squaresSum += value * value;
+			}
+
+			accumulator.m_peak = std::max(accumulator.m_peak, peak * Scale);
+			accumulator.m_sum += sum * Scale;
+			accumulator.m_squaresSum += squaresSum * (Scale * Scale);
+			accumulator.m_count += samplesCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Peak, RMS and DC offset in one pass.
+		static samples_measurement measure(const sample_t* samples, uint64_t samplesCount)
+		{
+			samples_accumulator accumulator;
+
+			accumulate(accumulator, samples, samplesCount);
+
+			return accumulator.result();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Largest magnitude, cheaper than measure(): integers stay in integer lanes.
+		static double peak(const sample_t* samples, uint64_t samplesCount)
+		{
+			return peak(samples, samplesCount, is_integral()) * Scale;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static double rms(const sample_t* samples, uint64_t samplesCount)
+		{
+			return measure(samples, samplesCount).m_rms;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static double dc_offset(const sample_t* samples, uint64_t samplesCount)
+		{
+			return measure(samples, samplesCount).m_dcOffset;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Subtracts the DC offset, which is returned.
+		static double remove_dc_offset(sample_t* samples, uint64_t samplesCount)
+		{
+			const double dcOffset = dc_offset(samples, samplesCount);
+			const math_t offset = static_cast<math_t>(dcOffset / Scale);
+			const auto offsetLanes = sample_math_lanes::broadcast(static_cast<math_t>(-offset));
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(3u);
+			uint64_t sampleIndex = 0u;
+
+			for (; sampleIndex != vectorSamplesCount; sampleIndex += 4u)
+			{
+				sample_math_lanes::store(samples + sampleIndex, sample_math_lanes::add(sample_math_lanes::load(samples + sampleIndex), broadcast_lanes(offsetLanes)));
+			}
+
+			for (; sampleIndex != samplesCount; ++sampleIndex)
+			{
+				sample_math_lanes::store(samples[sampleIndex], static_cast<math_t>(samples[sampleIndex]) + -offset, is_integral());
+			}
+
+			return dcOffset;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Multiplies samples by gain in place.
+		static void apply_gain(sample_t* samples, uint64_t samplesCount, float gain)
+		{
+			const math_t factor = static_cast<math_t>(gain);
+			const auto factorLanes = sample_math_lanes::broadcast(factor);
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(3u);
+			uint64_t sampleIndex = 0u;
+
+			for (; sampleIndex != vectorSamplesCount; sampleIndex += 4u)
+			{
+				sample_math_lanes::store(samples + sampleIndex, sample_math_lanes::multiply(sample_math_lanes::load(samples + sampleIndex), factorLanes));
+			}
+
+			for (; sampleIndex != samplesCount; ++sampleIndex)
+			{
+				sample_math_lanes::store(samples[sampleIndex], static_cast<math_t>(samples[sampleIndex]) * factor, is_integral());
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// output = sum of sources[i] * gains[i], summed in source order. output may be one of sources.
+		static void mix(sample_t* output, const sample_t* const* sources, const float* gains, uint32_t sourcesCount, uint64_t samplesCount)
+		{
+			assert(sourcesCount != 0u);
+
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(3u);
+			uint64_t sampleIndex = 0u;
+
+			for (; sampleIndex != vectorSamplesCount; sampleIndex += 4u)
+			{
+				auto mixed = sample_math_lanes::multiply(sample_math_lanes::load(sources[0] + sampleIndex), sample_math_lanes::broadcast(static_cast<math_t>(gains[0])));
+
+				for (uint32_t sourceIndex = 1u; sourceIndex != sourcesCount; ++sourceIndex)
+				{
+					mixed = sample_math_lanes::add(mixed, sample_math_lanes::multiply(sample_math_lanes::load(sources[sourceIndex] + sampleIndex), sample_math_lanes::broadcast(static_cast<math_t>(gains[sourceIndex]))));
+				}
+
+				sample_math_lanes::store(output + sampleIndex, mixed);
+			}
+
+			for (; sampleIndex != samplesCount; ++sampleIndex)
+			{
+				math_t mixed = static_cast<math_t>(sources[0][sampleIndex]) * static_cast<math_t>(gains[0]);
+
+				for (uint32_t sourceIndex = 1u; sourceIndex != sourcesCount; ++sourceIndex)
+				{
+					mixed = mixed + static_cast<math_t>(sources[sourceIndex][sampleIndex]) * static_cast<math_t>(gains[sourceIndex]);
+				}
+
+				sample_math_lanes::store(output[sampleIndex], mixed, is_integral());
+			}
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		forceinline static void load_double(const sample_t* input, __m128d& low, __m128d& high)
+		{
+			load_double(sample_math_lanes::load(input), low, high);
+		}
+
+		forceinline static void load_double(__m128 lanes, __m128d& low, __m128d& high)
+		{
+			low = _mm_cvtps_pd(lanes);
+			high = _mm_cvtps_pd(_mm_movehl_ps(lanes, lanes));
+		}
+
+		forceinline static void load_double(const sample_math_lanes::double_lanes& lanes, __m128d& low, __m128d& high)
+		{
+			low = lanes.m_low;
+			high = lanes.m_high;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline static __m128 broadcast_lanes(__m128 lanes)
+		{
+			return lanes;
+		}
+
+		forceinline static sample_math_lanes::double_lanes broadcast_lanes(__m128d lanes)
+		{
+			return sample_math_lanes::double_lanes{ lanes, lanes };
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Integer samples keep the largest and the smallest value, the minimum has no positive int32.
+		static double peak(const sample_t* samples, uint64_t samplesCount, std::true_type /* integral */)
+		{
+			const uint64_t vectorSamplesCount = samplesCount & ~uint64_t(3u);
+			__m128i maximumLanes = _mm_setzero_si128();
+			__m128i minimumLanes = _mm_setzero_si128();
+			uint64_t sampleIndex = 0u;
+
+			for (; sampleIndex != vectorSamplesCount; sampleIndex += 4u)
+			{
+				const __m128i lanes = sample_lanes<sample_t>::load(samples + sampleIndex);
+
+				maximumLanes = _mm_max_epi32(maximumLanes, lanes);
+				minimumLanes = _mm_min_epi32(minimumLanes, lanes);
+			}
+
+			maximumLanes = _mm_max_epi32(maximumLanes, _mm_shuffle_epi32(maximumLanes, _MM_SHUFFLE(1, 0, 3, 2)));
+			maximumLanes = _mm_max_epi32(maximumLanes, _mm_shuffle_epi32(maximumLanes, _MM_SHUFFLE(2, 3, 0, 1)));
+			minimumLanes = _mm_min_epi32(minimumLanes, _mm_shuffle_epi32(minimumLanes, _MM_SHUFFLE(1, 0, 3, 2)));
+			minimumLanes = _mm_min_epi32(minimumLanes, _mm_shuffle_epi32(minimumLanes, _MM_SHUFFLE(2, 3, 0, 1)));
+
+			int64_t maximum = _mm_cvtsi128_si32(maximumLanes);
+			int64_t minimum = _mm_cvtsi128_si32(minimumLanes);
+
+			for (; sampleIndex != samplesCount; ++sampleIndex)
+			{
+				const int64_t value = static_cast<int32_t>(samples[sampleIndex]);
+
+				maximum = std::max(maximum, value);
+				minimum = std::min(minimum, value);
+			}
+
+			return static_cast<double>(std::max(maximum, -minimum));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static double peak(const sample_t* samples, uint64_t samplesCount, std::false_type /* integral */)
+		{
+			samples_accumulator accumulator;
+
+			accumulate(accumulator, samples, samplesCount);
+
+			return accumulator.m_peak;
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// samples_measuring_converter - samples_converter measuring the output in the same pass
+	///
+	/// Converts block by block and measures every block while it is still in L1 cache, so memory
+	/// sees one pass instead of a conversion and a metering pass.
+	//-------------------------------------------------------------------------------------------------
+	template <typename input_t, typename output_t>
+	class samples_measuring_converter
+	{
+	private:
+		static constexpr uint32_t	BlockLength = 1024u;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		static void convert(const void* inputBuffer, output_t* outputBuffer, uint64_t samplesCount, samples_accumulator& accumulator)
+		{
+			const input_t* input = reinterpret_cast<const input_t*>(inputBuffer);
+
+			for (uint64_t blockStart = 0u; blockStart < samplesCount; blockStart += BlockLength)
+			{
+				const uint64_t blockLength = std::min<uint64_t>(BlockLength, samplesCount - blockStart);
+
+				samples_converter<input_t, output_t>::convert(input + blockStart, outputBuffer + blockStart, blockLength);
+				samples_statistics<output_t>::accumulate(accumulator, outputBuffer + blockStart, blockLength);
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		static samples_measurement convert(const void* inputBuffer, output_t* outputBuffer, uint64_t samplesCount)
+		{
+			samples_accumulator accumulator;
+
+			convert(inputBuffer, outputBuffer, samplesCount, accumulator);
+
+			return accumulator.result();
+		}
+	};
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "Hash.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// JumpConsistentHash
+	///
+	/// Lamping & Veach jump consistent hash: maps a 64 bit key hash to [0, shardsCount), growing
+	/// the shards count from N to N + 1 moves only 1 / (N + 1) of the keys, all of them to the new shard.
+	//-------------------------------------------------------------------------------------------------
+	inline uint32_t JumpConsistentHash(uint64_t keyHash, uint32_t shardsCount)
+	{
+		assert(shardsCount != 0u);
+
+		int64_t shardIndex = -1;
+		int64_t nextShardIndex = 0;
+
+		while (nextShardIndex < static_cast<int64_t>(shardsCount))
+		{
+			shardIndex = nextShardIndex;
+			keyHash = keyHash * 2862933555777941757ull + 1u;
+			nextShardIndex = static_cast<int64_t>(static_cast<double>(shardIndex + 1) * (static_cast<double>(1ll << 31) / static_cast<double>((keyHash >> 33) + 1u)));
+		}
+
+		return static_cast<uint32_t>(shardIndex);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	inline void JumpConsistentHash(const uint64_t* keyHashes, uint64_t keysCount, uint32_t shardsCount, uint32_t* shardIndices)
+	{
+		for (uint64_t keyIndex = 0u; keyIndex != keysCount; ++keyIndex)
+		{
+			shardIndices[keyIndex] = JumpConsistentHash(keyHashes[keyIndex], shardsCount);
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// ShardKeyHasher
+	//-------------------------------------------------------------------------------------------------
+	class ShardKeyHasher
+	{
+	public:
+		//---------------------------------------------------------------------------------------------
+		forceinline static uint64_t Calculate(const char* key)
+		{
+			return Hash64(key, strlen(key));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		forceinline static uint64_t Calculate(const std::string& key)
+		{
+			return Hash64(key.data(), key.size());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		forceinline static uint64_t Calculate(const KeyType& key)
+		{
+			return Hash64(&key, sizeof(KeyType));
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// JumpShardRouter
+	//-------------------------------------------------------------------------------------------------
+	class JumpShardRouter
+	{
+	private:
+		uint32_t					m_shardsCount;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline JumpShardRouter(uint32_t shardsCount) : m_shardsCount(shardsCount)
+		{
+			assert(shardsCount != 0u);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint32_t ShardsCount() const
+		{
+			return m_shardsCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void SetShardsCount(uint32_t shardsCount)
+		{
+			assert(shardsCount != 0u);
+			m_shardsCount = shardsCount;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		inline uint32_t Route(const KeyType& key) const
+		{
+			return JumpConsistentHash(ShardKeyHasher::Calculate(key), m_shardsCount);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		inline void RouteBatch(const KeyType* keys, uint64_t keysCount, uint32_t* shardIndices) const
+		{
+			for (uint64_t keyIndex = 0u; keyIndex != keysCount; ++keyIndex)
+			{
+				shardIndices[keyIndex] = JumpConsistentHash(ShardKeyHasher::Calculate(keys[keyIndex]), m_shardsCount);
+			}
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	/// RendezvousShardRouter
+	///
+	/// Weighted highest random weight hashing: every shard scores a key as weight / -ln(u), where u is
+	/// a uniform (0, 1) value mixed from the key hash and the shard seed; the best score wins. Shards are
+	/// identified by arbitrary ids, adding or removing a shard moves only the keys won or lost by it.
+	/// Costs O(shards count) per key, unlike jump hash it supports removal of any shard and weights.
+	//-------------------------------------------------------------------------------------------------
+	class RendezvousShardRouter
+	{
+	private:
+		std::vector<uint64_t>		m_shardIds;
+		std::vector<uint64_t>		m_shardSeeds;
+		std::vector<double>			m_shardWeights;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline void AddShard(uint64_t shardId, double weight = 1.0)
+		{
+			assert(weight > 0.0);
+			assert(std::find(m_shardIds.begin(), m_shardIds.end(), shardId) == m_shardIds.end());
+
+			m_shardIds.push_back(shardId);
+			m_shardSeeds.push_back(Hash64(&shardId, sizeof(shardId)));
+			m_shardWeights.push_back(weight);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool RemoveShard(uint64_t shardId)
+		{
+			const auto shardIter = std::find(m_shardIds.begin(), m_shardIds.end(), shardId);
+
+			if (shardIter == m_shardIds.end())
+			{
+				return false;
+			}
+
+			const size_t shardIndex = shardIter - m_shardIds.begin();
+
+			m_shardIds.erase(shardIter);
+			m_shardSeeds.erase(m_shardSeeds.begin() + shardIndex);
+			m_shardWeights.erase(m_shardWeights.begin() + shardIndex);
+
+			return true;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint32_t ShardsCount() const
+		{
+			return static_cast<uint32_t>(m_shardIds.size());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Returns id of the winning shard.
+		inline uint64_t RouteHash(uint64_t keyHash) const
+		{
+			assert(!m_shardIds.empty());
+
+			size_t bestShard = 0u;
+			double bestScore = -1.0;
+
+			for (size_t shardIndex = 0u; shardIndex != m_shardIds.size(); ++shardIndex)
+			{
+				const double score = Score(keyHash, shardIndex);
+
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestShard = shardIndex;
+				}
+			}
+
+			return m_shardIds[bestShard];
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename KeyType>
+		inline uint64_t Route(const KeyType& key) const
+		{
+			return RouteHash(ShardKeyHasher::Calculate(key));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Scores the batch shard by shard, so every pass streams over the key hashes only.
+		template <typename KeyType>
+		inline void RouteBatch(const KeyType* keys, uint64_t keysCount, uint64_t* shardIds) const
+		{
+			constexpr uint32_t BatchLength = 256u;
+
+			uint64_t keyHashes[BatchLength];
+			double bestScores[BatchLength];
+			uint32_t bestShards[BatchLength];
+
+			assert(!m_shardIds.empty());
+
+			for (uint64_t batchStart = 0u; batchStart < keysCount; batchStart += BatchLength)
+			{
+				const uint32_t batchLength = static_cast<uint32_t>(std::min<uint64_t>(keysCount - batchStart, BatchLength));
+
+				for (uint32_t keyIndex = 0u; keyIndex != batchLength; ++keyIndex)
+				{
+					keyHashes[keyIndex] = ShardKeyHasher::Calculate(keys[batchStart + keyIndex]);
+					bestScores[keyIndex] = -1.0;
+					bestShards[keyIndex] = 0u;
+				}
+
+				for (size_t shardIndex = 0u; shardIndex != m_shardIds.size(); ++shardIndex)
+				{
+					for (uint32_t keyIndex = 0u; keyIndex != batchLength; ++keyIndex)
+					{
+						const double score = Score(keyHashes[keyIndex], shardIndex);
+
+						if (score > bestScores[keyIndex])
+						{
+							bestScores[keyIndex] = score;
+							bestShards[keyIndex] = static_cast<uint32_t>(shardIndex);
+						}
+					}
+				}
+
+				for (uint32_t keyIndex = 0u; keyIndex != batchLength; ++keyIndex)
+				{
+					shardIds[batchStart + keyIndex] = m_shardIds[bestShards[keyIndex]];
+				}
+			}
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		forceinline double Score(uint64_t keyHash, size_t shardIndex) const
+		{
+			const uint64_t mixedHash = Hash<uint64_t>::Mix64(keyHash ^ m_shardSeeds[shardIndex]);
+			const double uniformValue = (static_cast<double>(mixedHash >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+
+			return m_shardWeights[shardIndex] / -log(uniformValue);
+		}
+	};
+}
@@ -0,0 +1,362 @@
+#pragma once
+
+#include "FixedArray.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// SmallFixedArray
+	///
+	/// Owning array which keeps up to InlineCapacity elements inside the object and spills to
+	/// AllocatorType storage beyond that. Empty arrays have no storage at all, so data() is nullptr.
+	/// It is a FixedArrayBase, hence it can be passed wherever the other array kinds are accepted and
+	/// viewed through FixedArray<DataType, MemoryOwnage::ExternalMemory>.
+	///
+	/// Unlike FixedArray the default alignment is the natural one, to not inflate the inline storage.
+	//-------------------------------------------------------------------------------------------------
+	template <typename DataType, uint32_t InlineCapacity, uint32_t Alignment = alignof(DataType), typename AllocatorType = HeapAllocator>
+	class SmallFixedArray : public FixedArrayBase<DataType>, private AllocatorType
+	{
+		static_assert(InlineCapacity != 0u, "Use FixedArray when there is no inline storage.");
+		static_assert(Alignment >= alignof(DataType) && (Alignment & (Alignment - 1u)) == 0u, "Alignment must be a power of two not weaker than the natural one.");
+
+	private:
+		alignas(Alignment) byte		m_inlineStorage[sizeof(DataType) * InlineCapacity];
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray()
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray(uint32_t size, const AllocatorType& allocator = AllocatorType()) : AllocatorType(allocator)
+		{
+			this->m_size = size;
+			this->m_value = AllocateStorage(size);
+
+			this->ConstructElements(this->m_value, size);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray(uint32_t size, const DataType& fillValue, const AllocatorType& allocator = AllocatorType()) : AllocatorType(allocator)
+		{
+			this->m_size = size;
+			this->m_value = AllocateStorage(size);
+
+			this->FillElements(this->m_value, size, fillValue);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray(const DataType* source, uint32_t sourceLength, const AllocatorType& allocator = AllocatorType()) : AllocatorType(allocator)
+		{
+			this->m_size = sourceLength;
+			this->m_value = AllocateStorage(sourceLength);
+
+			this->CopyConstructElements(this->m_value, source, sourceLength);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray(const FixedArrayBase<DataType>& source, const AllocatorType& allocator = AllocatorType()) : SmallFixedArray(source.data(), source.size(), allocator)
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray(const SmallFixedArray& source) : SmallFixedArray(source.data(), source.size(), source.GetAllocator())
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Heap storage is taken over, inline elements are moved one by one.
+		inline SmallFixedArray(SmallFixedArray&& source) : AllocatorType(source.GetAllocator())
+		{
+			TakeOver(source);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline ~SmallFixedArray()
+		{
+			Deallocate();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool IsInline() const
+		{
+			return this->m_size <= InlineCapacity;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Discards the content when the size changes.
+		inline SmallFixedArray& Allocate(uint32_t size)
+		{
+			if (this->m_size != size)
+			{
+				Deallocate();
+
+				this->m_size = size;
+				this->m_value = AllocateStorage(size);
+
+				this->ConstructElements(this->m_value, size);
+			}
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Keeps the leading min(size(), size) elements, new elements are default constructed.
+		inline SmallFixedArray& Reallocate(uint32_t size)
+		{
+			const uint32_t oldSize = ResizeStorage(size);
+
+			if (size > oldSize)
+			{
+				this->ConstructElements(this->m_value + oldSize, size - oldSize);
+			}
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Keeps the leading min(size(), size) elements, new elements are copies of fillValue.
+		inline SmallFixedArray& Resize(uint32_t size, const DataType& fillValue = DataType())
+		{
+			const DataType value(fillValue);
+			const uint32_t oldSize = ResizeStorage(size);
+
+			if (size > oldSize)
+			{
+				this->FillElements(this->m_value + oldSize, size - oldSize, value);
+			}
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void Deallocate()
+		{
+			this->DestroyElements(this->m_value, this->m_size);
+			DeallocateStorage(this->m_value, this->m_size);
+
+			this->m_value = nullptr;
+			this->m_size = 0;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool IsAllocated() const
+		{
+			return this->m_value != nullptr;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline const AllocatorType& GetAllocator() const
+		{
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray& Copy(const DataType* source, uint32_t sourceLength)
+		{
+			if (this->m_size == sourceLength)
+			{
+				if (this->m_value != source)
+				{
+					this->CopyElements(this->m_value, source, sourceLength);
+				}
+
+				return *this;
+			}
+
+			if (Contains(source))
+			{
+				// Inline storage is reused in place, so copy a range of itself through a temporary
+				SmallFixedArray sourceCopy(source, sourceLength, GetAllocator());
+
+				return *this = std::move(sourceCopy);
+			}
+
+			Deallocate();
+
+			this->m_size = sourceLength;
+			this->m_value = AllocateStorage(sourceLength);
+
+			this->CopyConstructElements(this->m_value, source, sourceLength);
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray& Copy(const FixedArrayBase<DataType>& source)
+		{
+			return Copy(source.data(), source.size());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray& Append(const DataType* source, uint32_t sourceLength)
+		{
+			if (sourceLength == 0u)
+			{
+				return *this;
+			}
+
+			// Source may point into this array, the storage may move while it grows
+			const bool sourceInside = Contains(source);
+			const size_t sourceOffset = sourceInside ? source - this->m_value : 0u;
+			const uint32_t oldSize = ResizeStorage(this->m_size + sourceLength);
+
+			this->CopyConstructElements(this->m_value + oldSize, sourceInside ? this->m_value + sourceOffset : source, sourceLength);
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray& Append(const FixedArrayBase<DataType>& source)
+		{
+			return Append(source.data(), source.size());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray& Swap(SmallFixedArray& another)
+		{
+			if (!IsInline() && !another.IsInline())
+			{
+				std::swap(this->m_value, another.m_value);
+				std::swap(this->m_size, another.m_size);
+				std::swap(static_cast<AllocatorType&>(*this), static_cast<AllocatorType&>(another));
+
+				return *this;
+			}
+
+			SmallFixedArray temporary(std::move(another));
+
+			another = std::move(*this);
+			*this = std::move(temporary);
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray& operator= (const FixedArrayBase<DataType>& source)
+		{
+			return Copy(source);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray& operator= (const SmallFixedArray& source)
+		{
+			return Copy(source);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SmallFixedArray& operator= (SmallFixedArray&& source)
+		{
+			if (this == &source)
+			{
+				return *this;
+			}
+
+			Deallocate();
+			TakeOver(source);
+
+			return *this;
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		inline DataType* InlineElements()
+		{
+			return reinterpret_cast<DataType*>(m_inlineStorage);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline bool Contains(const DataType* element) const
+		{
+			return std::greater_equal<const DataType*>()(element, this->m_value) && std::less<const DataType*>()(element, this->m_value + this->m_size);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline DataType* AllocateStorage(uint32_t elementsCount)
+		{
+			if (elementsCount == 0u)
+			{
+				return nullptr;
+			}
+
+			if (elementsCount <= InlineCapacity)
+			{
+				return InlineElements();
+			}
+
+			return static_cast<DataType*>(AllocatorType::Allocate(sizeof(DataType) * elementsCount, Alignment));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void DeallocateStorage(DataType* elements, uint32_t elementsCount)
+		{
+			if (elementsCount > InlineCapacity)
+			{
+				AllocatorType::Deallocate(elements, sizeof(DataType) * elementsCount);
+			}
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Changes the storage size keeping the leading elements, returns the old size.
+		/// Elements past the old size are left unconstructed.
+		inline uint32_t ResizeStorage(uint32_t size)
+		{
+			const uint32_t oldSize = this->m_size;
+
+			if (size == oldSize)
+			{
+				return oldSize;
+			}
+
+			if (size < oldSize)
+			{
+				this->DestroyElements(this->m_value + size, oldSize - size);
+			}
+
+			if (oldSize <= InlineCapacity && size <= InlineCapacity)
+			{
+				this->m_value = size ? InlineElements() : nullptr;
+			}
+			else if (oldSize > InlineCapacity && size > InlineCapacity && IsTriviallyRelocatable<DataType>::value)
+			{
+				this->m_value = static_cast<DataType*>(AllocatorType::Reallocate(this->m_value, sizeof(DataType) * oldSize, sizeof(DataType) * size, Alignment));
+			}
+			else
+			{
+				DataType* newValue = AllocateStorage(size);
+
+				this->RelocateElements(newValue, this->m_value, std::min(size, oldSize));
+				DeallocateStorage(this->m_value, oldSize);
+
+				this->m_value = newValue;
+			}
+
+			this->m_size = size;
+
+			return oldSize;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Moves the content of source into this empty array, source becomes empty.
+		inline void TakeOver(SmallFixedArray& source)
+		{
+			if (source.IsInline())
+			{
+				this->m_value = AllocateStorage(source.m_size);
+				this->RelocateElements(this->m_value, source.m_value, source.m_size);
+			}
+			else
+			{
+				this->m_value = source.m_value;
+				static_cast<AllocatorType&>(*this) = source.GetAllocator();
+			}
+
+			this->m_size = source.m_size;
+			source.m_value = nullptr;
+			source.m_size = 0;
+		}
+	};
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "FixedArray.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// SoaArray
+	///
+	/// Struct-of-arrays container, every field lives in its own cache line aligned FixedArray column
+	/// so loops touching a few fields do not drag the others through the cache. All columns always
+	/// have the same size. Elements are accessed through proxies, std::tuple<FieldTypes&...>, which
+	/// read and assign as a whole or field by field with std::get. Column<I>() gives a view of a single
+	/// column for vectorized kernels.
+	//-------------------------------------------------------------------------------------------------
+	template <typename... FieldTypes>
+	class SoaArray
+	{
+		static_assert(sizeof...(FieldTypes) != 0u, "SoaArray needs at least one field.");
+
+	public:
+		typedef std::tuple<FieldTypes...>				ValueType;
+		typedef std::tuple<FieldTypes&...>				Reference;
+		typedef std::tuple<const FieldTypes&...>		ConstReference;
+
+		static constexpr uint32_t	ColumnsCount = static_cast<uint32_t>(sizeof...(FieldTypes));
+		static constexpr uint32_t	ColumnAlignment = 64u;
+
+		template <uint32_t ColumnIndex>
+		using FieldType = typename std::tuple_element<ColumnIndex, ValueType>::type;
+
+		template <typename ColumnFieldType>
+		using ColumnType = FixedArray<ColumnFieldType, MemoryOwnage::OwnsMemory, std::max<uint32_t>(ColumnAlignment, alignof(ColumnFieldType))>;
+
+	private:
+		typedef std::index_sequence_for<FieldTypes...>	ColumnIndices;
+
+	private:
+		std::tuple<ColumnType<FieldTypes>...>			m_columns;
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		inline SoaArray()
+		{
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SoaArray(uint32_t size)
+		{
+			Allocate(size);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline uint32_t size() const
+		{
+			return std::get<0>(m_columns).size();
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Discards the content when the size changes, fields of trivial types are left uninitialized.
+		inline SoaArray& Allocate(uint32_t size)
+		{
+			ForEachColumn([size](auto& column) { column.Allocate(size); }, ColumnIndices());
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Keeps the leading elements, fields of new elements are default constructed.
+		inline SoaArray& Reallocate(uint32_t size)
+		{
+			ForEachColumn([size](auto& column) { column.Reallocate(size); }, ColumnIndices());
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Keeps the leading elements, new elements are copies of fillValue.
+		inline SoaArray& Resize(uint32_t size, const ValueType& fillValue = ValueType())
+		{
+			ResizeColumns(size, fillValue, ColumnIndices());
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline void Deallocate()
+		{
+			ForEachColumn([](auto& column) { column.Deallocate(); }, ColumnIndices());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		inline SoaArray& Swap(SoaArray& another)
+		{
+			SwapColumns(another, ColumnIndices());
+
+			return *this;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename IndexType>
+		inline Reference operator[] (IndexType index)
+		{
+			assert(index < static_cast<IndexType>(size()));
+			return MakeReference(static_cast<uint32_t>(index), ColumnIndices());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename IndexType>
+		inline ConstReference operator[] (IndexType index) const
+		{
+			assert(index < static_cast<IndexType>(size()));
+			return MakeReference(static_cast<uint32_t>(index), ColumnIndices());
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <uint32_t ColumnIndex, typename IndexType>
+		inline FieldType<ColumnIndex>& Get(IndexType index)
+		{
+			return std::get<ColumnIndex>(m_columns)[index];
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <uint32_t ColumnIndex, typename IndexType>
+		inline const FieldType<ColumnIndex>& Get(IndexType index) const
+		{
+			return std::get<ColumnIndex>(m_columns)[index];
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <typename IndexType>
+		inline void Set(IndexType index, const FieldTypes&... fieldValues)
+		{
+			operator[](index) = std::tie(fieldValues...);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		/// Column view, its data() is aligned to at least ColumnAlignment bytes.
+		template <uint32_t ColumnIndex>
+		inline FixedArray<FieldType<ColumnIndex>, MemoryOwnage::ExternalMemory> Column()
+		{
+			return FixedArray<FieldType<ColumnIndex>, MemoryOwnage::ExternalMemory>(std::get<ColumnIndex>(m_columns));
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <uint32_t ColumnIndex>
+		inline FixedArray<const FieldType<ColumnIndex>, MemoryOwnage::ExternalMemory> Column() const
+		{
+			const auto& column = std::get<ColumnIndex>(m_columns);
+
+			return FixedArray<const FieldType<ColumnIndex>, MemoryOwnage::ExternalMemory>(column.data(), column.size());
+		}
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		template <typename FunctionType, size_t... ColumnIndex>
+		inline void ForEachColumn(FunctionType&& columnFunction, std::index_sequence<ColumnIndex...>)
+		{
+			const int expansion[] = { (columnFunction(std::get<ColumnIndex>(m_columns)), 0)... };
+			(void)expansion;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <size_t... ColumnIndex>
+		inline void ResizeColumns(uint32_t size, const ValueType& fillValue, std::index_sequence<ColumnIndex...>)
+		{
+			const int expansion[] = { (std::get<ColumnIndex>(m_columns).Resize(size, std::get<ColumnIndex>(fillValue)), 0)... };
+			(void)expansion;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <size_t... ColumnIndex>
+		inline void SwapColumns(SoaArray& another, std::index_sequence<ColumnIndex...>)
+		{
+			const int expansion[] = { (std::get<ColumnIndex>(m_columns).Swap(std::get<ColumnIndex>(another.m_columns)), 0)... };
+			(void)expansion;
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <size_t... ColumnIndex>
+		inline Reference MakeReference(uint32_t index, std::index_sequence<ColumnIndex...>)
+		{
+			return Reference(std::get<ColumnIndex>(m_columns)[index]...);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		template <size_t... ColumnIndex>
+		inline ConstReference MakeReference(uint32_t index, std::index_sequence<ColumnIndex...>) const
+		{
+			return ConstReference(std::get<ColumnIndex>(m_columns)[index]...);
+		}
+	};
+}
@@ -0,0 +1,178 @@
+#include "platform.h"
+#include "ThreadPool.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	static thread_local bool		t_insideThreadPool = false;
+
+	//-------------------------------------------------------------------------------------------------
+	/// Marks the calling thread as running tasks until the end of the scope, also when a task throws.
+	//-------------------------------------------------------------------------------------------------
+	class InsideThreadPoolScope : public boost::noncopyable
+	{
+	public:
+		InsideThreadPoolScope()
+		{
+			t_insideThreadPool = true;
+		}
+
+		~InsideThreadPoolScope()
+		{
+			t_insideThreadPool = false;
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	ThreadPool::ThreadPool(uint32_t threadsCount) :
+		m_taskFunction(nullptr),
+		m_tasksCount(0u),
+		m_nextTask(0u),
+		m_generation(0u),
+		m_busyWorkers(0u),
+		m_stopping(false)
+	{
+		if (threadsCount == 0u)
+		{
+			threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		m_threads.reserve(threadsCount - 1u);
+
+		for (uint32_t threadIndex = 1u; threadIndex < threadsCount; ++threadIndex)
+		{
+			m_threads.emplace_back(&ThreadPool::WorkerLoop, this);
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> stateLock(m_stateMutex);
+			m_stopping = true;
+		}
+
+		m_wakeCondition.notify_all();
+
+		for (auto& workerThread : m_threads)
+		{
+			workerThread.join();
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	void ThreadPool::ParallelFor(uint64_t tasksCount, const TaskFunction& taskFunction)
+	{
+		if (m_threads.empty() || tasksCount < 2u || t_insideThreadPool)
+		{
+			for (uint64_t taskIndex = 0u; taskIndex != tasksCount; ++taskIndex)
+			{
+				taskFunction(taskIndex);
+			}
+			return;
+		}
+
+		std::lock_guard<std::mutex> jobLock(m_jobMutex);
+
+		// Publish the job
+		{
+			std::lock_guard<std::mutex> stateLock(m_stateMutex);
+
+			m_taskFunction = &taskFunction;
+			m_tasksCount = tasksCount;
+			m_nextTask.store(0u, std::memory_order_relaxed);
+			m_taskException = nullptr;
+			m_busyWorkers = static_cast<uint32_t>(m_threads.size());
+			++m_generation;
+		}
+
+		m_wakeCondition.notify_all();
+
+		// Take part in the job
+		{
+			InsideThreadPoolScope insideScope;
+			RunTasks();
+		}
+
+		// Wait for the workers, taskFunction must outlive their tasks even when one of them threw
+		std::unique_lock<std::mutex> stateLock(m_stateMutex);
+		m_doneCondition.wait(stateLock, [this] { return m_busyWorkers == 0u; });
+
+		m_taskFunction = nullptr;
+
+		if (m_taskException)
+		{
+			std::exception_ptr taskException = m_taskException;
+			m_taskException = nullptr;
+
+			std::rethrow_exception(taskException);
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	ThreadPool& ThreadPool::Shared()
+	{
+		static ThreadPool sharedPool;
+		return sharedPool;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	void ThreadPool::WorkerLoop()
+	{
+		InsideThreadPoolScope insideScope;
+
+		uint64_t processedGeneration = 0u;
+
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> stateLock(m_stateMutex);
+				m_wakeCondition.wait(stateLock, [&] { return m_stopping || m_generation != processedGeneration; });
+
+				if (m_stopping)
+				{
+					return;
+				}
+
+				processedGeneration = m_generation;
+			}
+
+			RunTasks();
+
+			{
+				std::lock_guard<std::mutex> stateLock(m_stateMutex);
+
+				if (--m_busyWorkers == 0u)
+				{
+					m_doneCondition.notify_one();
+				}
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	/// Never throws, the first exception is kept for ParallelFor and the remaining tasks are skipped.
+	void ThreadPool::RunTasks()
+	{
+		try
+		{
+			for (uint64_t taskIndex = m_nextTask.fetch_add(1u, std::memory_order_relaxed); taskIndex < m_tasksCount; taskIndex = m_nextTask.fetch_add(1u, std::memory_order_relaxed))
+			{
+				(*m_taskFunction)(taskIndex);
+			}
+		}
+		catch (...)
+		{
+			m_nextTask.store(m_tasksCount, std::memory_order_relaxed);
+
+			std::lock_guard<std::mutex> stateLock(m_stateMutex);
+
+			if (!m_taskException)
+			{
+				m_taskException = std::current_exception();
+			}
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// ThreadPool
+	///
+	/// Fixed set of worker threads executing one indexed job at a time. The calling thread takes part
+	/// in the job too, tasks are handed out dynamically through an atomic counter so uneven tasks
+	/// balance themselves. Jobs started from inside a task run serially on the current thread. The
+	/// first exception thrown by a task stops handing out the remaining tasks, ParallelFor waits for
+	/// the running ones and rethrows it on the calling thread.
+	//-------------------------------------------------------------------------------------------------
+	class ThreadPool : public boost::noncopyable
+	{
+	public:
+		typedef std::function<void(uint64_t taskIndex)> TaskFunction;
+
+	private:
+		std::vector<std::thread>	m_threads;
+		std::mutex					m_jobMutex;						///< serializes jobs started from different threads
+		std::mutex					m_stateMutex;
+		std::condition_variable		m_wakeCondition;
+		std::condition_variable		m_doneCondition;
+		const TaskFunction*			m_taskFunction;
+		uint64_t					m_tasksCount;
+		std::atomic<uint64_t>		m_nextTask;
+		std::exception_ptr			m_taskException;				///< first exception thrown by a task of the job
+		uint64_t					m_generation;
+		uint32_t					m_busyWorkers;
+		bool						m_stopping;
+
+	public:
+		/// Zero threads count means one thread per hardware thread (the caller included).
+		ThreadPool(uint32_t threadsCount = 0u);
+		~ThreadPool();
+
+		/// Runs taskFunction(0 .. tasksCount - 1) and returns when all of them are finished, rethrows
+		/// the first exception thrown by a task.
+		void ParallelFor(uint64_t tasksCount, const TaskFunction& taskFunction);
+
+		/// Process-wide pool sized for the machine.
+		static ThreadPool& Shared();
+
+	public:
+		//---------------------------------------------------------------------------------------------
+		/// Number of threads executing a job, including the calling one.
+		inline uint32_t ThreadsCount() const
+		{
+			return static_cast<uint32_t>(m_threads.size()) + 1u;
+		}
+
+	private:
+		void WorkerLoop();
+		void RunTasks();
+	};
+}
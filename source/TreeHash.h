@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Hash.h"
+#include "FixedArray.h"
+#include "ThreadPool.h"
+
+
+namespace aux
+{
+	//-------------------------------------------------------------------------------------------------
+	/// TreeHash64
+	///
+	/// Splits the buffer into leaves of fixed length, hashes the leaves in parallel with 128 bit Murmur3
+	/// and hashes the ordered leaf digests together with the buffer and leaf lengths. The result depends
+	/// only on the data and the leaf length, never on the threads count; it differs from Hash64().
+	//-------------------------------------------------------------------------------------------------
+	constexpr uint64_t				DefaultTreeHashLeafLength = 1u << 20;
+
+	inline uint64_t TreeHash64(const void* buffer, uint64_t bufferLength, uint64_t leafLength = DefaultTreeHashLeafLength, ThreadPool& threadPool = ThreadPool::Shared())
+	{
+		assert(leafLength != 0u);
+
+		const byte* bufferData = reinterpret_cast<const byte*>(buffer);
+		const uint64_t leavesCount = std::max<uint64_t>((bufferLength + leafLength - 1u) / leafLength, 1u);
+
+		LargeFixedArray<uint64_t> leafDigests(leavesCount * 2u);
+
+		threadPool.ParallelFor(leavesCount, [&](uint64_t leafIndex)
+		{
+			const uint64_t leafStart = leafIndex * leafLength;
+			const uint64_t currentLeafLength = std::min(bufferLength - leafStart, leafLength);
+
+			Hash<uint64_t>::Calculate128(bufferData + leafStart, currentLeafLength, 1u, leafDigests[leafIndex * 2u], leafDigests[leafIndex * 2u + 1u]);
+		});
+
+		Hash<uint64_t> rootHasher;
+
+		return rootHasher.Add(leafDigests.data(), leavesCount * 2u * sizeof(uint64_t)).Add(bufferLength).Add(leafLength).GetInternalValue();
+	}
+}
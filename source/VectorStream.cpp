@@ -1,12 +1,13 @@
 #include "platform.h"
 #include "VectorStream.h"
+#include "Arena.h"
 
 
 namespace aux
 {
 	//-------------------------------------------------------------------------------------------------
-	template <bool OwnVector>
-	IStream::StreamPos VectorStream<OwnVector>::Read(byte* outputBuffer, StreamPos bytesToRead)
+	template <bool OwnVector, typename VectorAllocatorType>
+	IStream::StreamPos VectorStream<OwnVector, VectorAllocatorType>::Read(byte* outputBuffer, StreamPos bytesToRead)
 	{
 		bytesToRead = std::min(m_currentPosition + bytesToRead, static_cast<StreamPos>(m_memoryBuffer.size())) - m_currentPosition;
 
@@ -18,15 +19,15 @@ namespace aux
 	}
 
 	//-------------------------------------------------------------------------------------------------
-	template <bool OwnVector>
-	IStream::StreamPos VectorStream<OwnVector>::Write(const void* inputBuffer, StreamPos bytesToWrite)
+	template <bool OwnVector, typename VectorAllocatorType>
+	IStream::StreamPos VectorStream<OwnVector, VectorAllocatorType>::Write(const void* inputBuffer, StreamPos bytesToWrite)
 	{
 		return FastWrite(inputBuffer, bytesToWrite);
 	}
 
 	//-------------------------------------------------------------------------------------------------
-	template <bool OwnVector>
-	IStream::StreamPos VectorStream<OwnVector>::Seek(SeekOrigin seekOrigin, StreamSeek bytesToSeek)
+	template <bool OwnVector, typename VectorAllocatorType>
+	IStream::StreamPos VectorStream<OwnVector, VectorAllocatorType>::Seek(SeekOrigin seekOrigin, StreamSeek bytesToSeek)
 	{
 		const auto ClampStreamPos = [&](StreamSeek newPos)->StreamPos
 		{
@@ -60,8 +61,8 @@ namespace aux
 	}
 
 	//-------------------------------------------------------------------------------------------------
-	template <bool OwnVector>
-	IStream::StreamPos VectorStream<OwnVector>::SetLength(StreamPos requiredLength)
+	template <bool OwnVector, typename VectorAllocatorType>
+	IStream::StreamPos VectorStream<OwnVector, VectorAllocatorType>::SetLength(StreamPos requiredLength)
 	{
 		if (m_memoryBuffer.size() != requiredLength)
 		{
@@ -77,30 +78,30 @@ namespace aux
 	}
 
 	//-------------------------------------------------------------------------------------------------
-	template <bool OwnVector>
-	IStream::StreamPos VectorStream<OwnVector>::Tell() const
+	template <bool OwnVector, typename VectorAllocatorType>
+	IStream::StreamPos VectorStream<OwnVector, VectorAllocatorType>::Tell() const
 	{
 		return m_currentPosition;
 	}
 
 	//-------------------------------------------------------------------------------------------------
-	template <bool OwnVector>
-	IStream::StreamPos VectorStream<OwnVector>::Length() const
+	template <bool OwnVector, typename VectorAllocatorType>
+	IStream::StreamPos VectorStream<OwnVector, VectorAllocatorType>::Length() const
 	{
 		return m_memoryBuffer.size();
 	}
 
 	//-------------------------------------------------------------------------------------------------
-	template <bool OwnVector>
-	bool VectorStream<OwnVector>::Reserve(StreamPos requiredCapacity)
+	template <bool OwnVector, typename VectorAllocatorType>
+	bool VectorStream<OwnVector, VectorAllocatorType>::Reserve(StreamPos requiredCapacity)
 	{
 		m_memoryBuffer.reserve(requiredCapacity);
 		return true;
 	}
 
 	//-------------------------------------------------------------------------------------------------
-	template <bool OwnVector>
-	const byte* VectorStream<OwnVector>::EntireData() const
+	template <bool OwnVector, typename VectorAllocatorType>
+	const byte* VectorStream<OwnVector, VectorAllocatorType>::EntireData() const
 	{
 		return m_memoryBuffer.data();
 	}
@@ -108,4 +109,6 @@ namespace aux
 	//-------------------------------------------------------------------------------------------------
 	template class VectorStream<true>;
 	template class VectorStream<false>;
+	template class VectorStream<true, StlAllocator<byte, ArenaAllocator> >;
+	template class VectorStream<false, StlAllocator<byte, ArenaAllocator> >;
 }
@@ -6,11 +6,18 @@
 
 namespace aux
 {
-	template <bool OwnVector = true>
+	//-------------------------------------------------------------------------------------------------
+	/// VectorStream
+	///
+	/// Memory stream over an owned or referenced std::vector. VectorAllocatorType may place the vector
+	/// into an Arena: VectorStream<true, StlAllocator<byte, ArenaAllocator>> is instantiated along with
+	/// the default one.
+	//-------------------------------------------------------------------------------------------------
+	template <bool OwnVector = true, typename VectorAllocatorType = std::allocator<byte> >
 	class VectorStream : public IMemoryStream, public boost::noncopyable
 	{
 	private:
-		typedef std::vector<byte> ContainerType;
+		typedef std::vector<byte, VectorAllocatorType> ContainerType;
 		typedef std::conditional_t<OwnVector, ContainerType, std::add_lvalue_reference_t<ContainerType> > VectorHolderType;
 		typedef std::decay_t<VectorHolderType> VectorType;
 
@@ -25,7 +32,7 @@ namespace aux
 		}
 
 		template <bool LocalOwnVector = OwnVector, typename = std::enable_if_t<LocalOwnVector> >
-		inline VectorStream(StreamPos capacity = 0u) : m_currentPosition(0u)
+		inline VectorStream(StreamPos capacity = 0u, const VectorAllocatorType& allocator = VectorAllocatorType()) : m_memoryBuffer(allocator), m_currentPosition(0u)
 		{
 			m_memoryBuffer.reserve(capacity);
 		}